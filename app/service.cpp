@@ -0,0 +1,25 @@
+/**
+ * service.cpp
+ *
+ * Keeps one solver loaded and answers solve requests from local clients.
+ * Usage: wordscraper_service [socket path] [thread count]
+ */
+
+#include "core/pch.hpp"
+#include "core/service.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char **argv) {
+  const fs::path socketPath = argc > 1 ? fs::path(argv[1]) : wsr::SolverService::defaultSocketPath();
+  const std::size_t threadCount = argc > 2 ? std::size_t(std::max(0, std::atoi(argv[2]))) : 0;
+  try {
+    wsr::SolverService service(socketPath, threadCount);
+    service.run();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+/**
+ * snapshot.cpp
+ *
+ * Compiles the text sources of the database into a binary snapshot.
+ * Usage: wordscraper_snapshot [data directory] [output file]
+ */
+
+#include "core/pch.hpp"
+#include "core/snapshot.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char **argv) {
+  const fs::path dataDirectory = argc > 1 ? fs::path(argv[1]) : wsr::utils::getRoot() / "data";
+  const fs::path output = argc > 2 ? fs::path(argv[2])
+                                   : dataDirectory / wsr::detail::Database::snapshotFileName;
+  try {
+    const std::vector<std::byte> image = wsr::detail::Database::compile(dataDirectory);
+    wsr::detail::writeSnapshot(output, image);
+    wsr::utils::logMessage(
+        wsr::utils::LogSeverity::LOG_INFO,
+        std::format("Wrote {} ({} KiB).", output.string(), image.size() / 1024)
+    );
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
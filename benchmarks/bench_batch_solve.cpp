@@ -0,0 +1,105 @@
+/**
+ * bench_batch_solve.cpp
+ *
+ * Solves every level in data.txt through Solver::solve, once with the database
+ * lookup and once with the lookup turned off so every level goes through the
+ * dictionary fallback. Levels are spread over N threads sharing one solver,
+ * given as the first argument and defaulting to every hardware thread, and over
+ * one thread for reference. Reports levels per second, the latency percentiles
+ * and how many solves match the stored answers. Returns the number of lookup
+ * solves that do not match, so the run can gate regressions.
+ */
+
+#include "bench_common.hpp"
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/utilities.hpp"
+
+using Clock = std::chrono::steady_clock;
+using wsr::bench::BenchLevel;
+using wsr::bench::loadLevels;
+using wsr::bench::normalized;
+using wsr::bench::percentile;
+
+int main(int argc, char **argv) {
+  const std::size_t threadCount =
+      argc > 1 ? std::size_t(std::max(1, std::atoi(argv[1])))
+               : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const std::vector<BenchLevel> levels = loadLevels(wsr::utils::getRoot() / "data" / "data.txt");
+  std::vector<std::vector<std::string>> stored = {};
+  for (const auto &level : levels) {
+    stored.push_back(normalized(level.words));
+  }
+
+  wsr::Solver solver = {};
+  solver.setSearchThreads(1);
+
+  // Solves every level once on the given number of threads. Returns the number
+  // of levels whose answers differ from the stored ones.
+  const auto runPass = [&](std::string_view name, std::size_t threads) {
+    std::vector<double> latencyUs(levels.size());
+    std::vector<std::vector<std::string>> answers(levels.size());
+    std::atomic<std::size_t> next = 0;
+
+    const auto start = Clock::now();
+    {
+      wsr::utils::ThreadPool pool(threads);
+      std::vector<std::future<void>> workers = {};
+      for (std::size_t t = 0; t < threads; ++t) {
+        workers.push_back(pool.submit([&] {
+          for (std::size_t i = next++; i < levels.size(); i = next++) {
+            const auto levelStart = Clock::now();
+            const std::vector<std::string_view> words = solver.solve(levels[i].grid, levels[i].letters);
+            const std::chrono::duration<double, std::micro> elapsed = Clock::now() - levelStart;
+            latencyUs[i] = elapsed.count();
+            answers[i] = normalized(words);
+          }
+        }));
+      }
+      for (auto &worker : workers) {
+        worker.get();
+      }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::size_t matching = 0;
+    std::size_t found = 0;
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+      matching += answers[i] == stored[i];
+      total += stored[i].size();
+      for (const auto &word : answers[i]) {
+        found += std::binary_search(stored[i].begin(), stored[i].end(), word);
+      }
+    }
+    std::cout << std::format(
+        "{} ({} threads): {:.0f} levels/s, p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us per level, "
+        "{}/{} levels matching, {:.1f}% of stored answers found\n",
+        name,
+        threads,
+        double(levels.size()) / elapsed.count(),
+        percentile(latencyUs, 0.5),
+        percentile(latencyUs, 0.99),
+        percentile(latencyUs, 1.0),
+        matching,
+        levels.size(),
+        100.0 * double(found) / double(std::max<std::size_t>(total, 1))
+    );
+    return levels.size() - matching;
+  };
+
+  std::vector<std::size_t> threadCounts = {1};
+  if (threadCount != 1) {
+    threadCounts.push_back(threadCount);
+  }
+  std::size_t failures = 0;
+  for (const auto threads : threadCounts) {
+    failures = std::max(failures, runPass("Database lookup", threads));
+  }
+  solver.setDatabaseLookup(false);
+  for (const auto threads : threadCounts) {
+    std::ignore = runPass("Dictionary fallback", threads);
+  }
+  return int(std::min<std::size_t>(failures, INT_MAX));
+}
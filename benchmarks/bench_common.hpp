@@ -0,0 +1,70 @@
+/**
+ * bench_common.hpp
+ *
+ * Levels from data.txt and the statistics the benchmarks report on them.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+#include "core/types.hpp"
+#include "utils/utilities.hpp"
+
+namespace wsr::bench {
+
+struct BenchLevel {
+  Matrix<char> grid = {};
+  std::string letters = {};  // The longest answer, which holds every wheel letter.
+  std::vector<std::string> words = {};
+};
+
+// Reads one level per line: width, height, row-major layout and answers.
+inline std::vector<BenchLevel> loadLevels(const std::filesystem::path &path) {
+  WSR_EXCEPTMSG(layoutErrMsg) = "Level layout does not match its size.";
+  std::vector<BenchLevel> levels = {};
+  std::ifstream stream(path);
+  std::string line = {};
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::size_t width = {};
+    std::size_t height = {};
+    std::string layout = {};
+    fields >> width >> height >> layout;
+    utils::runtimeRequire(layout.size() == width * height, WSR_EXCEPTION(layoutErrMsg));
+
+    BenchLevel level = {Matrix<char>(width, height)};
+    for (int y = 0; std::size_t(y) < height; ++y) {
+      for (int x = 0; std::size_t(x) < width; ++x) {
+        level.grid[{x, y}] = layout[std::size_t(y) * width + std::size_t(x)];
+      }
+    }
+    std::string word = {};
+    while (fields >> word) {
+      level.letters = word.size() > level.letters.size() ? word : level.letters;
+      level.words.push_back(word);
+    }
+    levels.push_back(std::move(level));
+  }
+  return levels;
+}
+
+// Uppercase words in sorted order, so answers compare regardless of order and case.
+template <typename Words>
+std::vector<std::string> normalized(const Words &words) {
+  std::vector<std::string> result(words.begin(), words.end());
+  for (auto &word : result) {
+    std::transform(word.begin(), word.end(), word.begin(), [](char c) {
+      return char(std::toupper(c));
+    });
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// Sorts the times in place.
+inline double percentile(std::vector<double> &times, double p) {
+  std::sort(times.begin(), times.end());
+  return times.empty() ? 0.0 : times[std::size_t(p * double(times.size() - 1))];
+}
+
+}  // namespace wsr::bench
@@ -0,0 +1,121 @@
+/**
+ * bench_crossword.cpp
+ *
+ * Solves every level in data.txt with the crossword engine behind the
+ * dictionary fallback, as if none of the levels were stored, and reports
+ * the solve times and how many fills match the stored answers. Levels are
+ * searched on one thread, under tight deadlines and with the parallel portfolio.
+ * Also compares analyzing each layout against the analyses cached by the database.
+ */
+
+#include "bench_common.hpp"
+#include "core/crossword.hpp"
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+using Clock = std::chrono::steady_clock;
+using wsr::bench::BenchLevel;
+using wsr::bench::loadLevels;
+using wsr::bench::normalized;
+using wsr::bench::percentile;
+
+int main() {
+  const wsr::detail::Database database = {};
+  const std::vector<BenchLevel> levels = loadLevels(wsr::utils::getRoot() / "data" / "data.txt");
+
+  const auto timeAnalyses = [&levels](auto &&analyze) {
+    std::size_t slots = 0;
+    const auto start = Clock::now();
+    for (const auto &level : levels) {
+      slots += analyze(*wsr::detail::LayoutKey::fromGrid(level.grid));
+    }
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return std::pair(elapsed.count() / double(std::max<std::size_t>(levels.size(), 1)), slots);
+  };
+  const auto [analyzeUs, analyzedSlots] = timeAnalyses([](const wsr::detail::LayoutKey &key) {
+    return wsr::detail::analyzeLayout(key).slots.size();
+  });
+  const auto [cachedUs, cachedSlots] = timeAnalyses([&database](const wsr::detail::LayoutKey &key) {
+    return database.layoutAnalysis(key).slots.size();
+  });
+  std::cout << std::format(
+      "Layout analysis: {:.2f} us computed, {:.2f} us cached per level, {} mismatched slot counts\n",
+      analyzeUs,
+      cachedUs,
+      analyzedSlots != cachedSlots
+  );
+
+  // Solves every level with a given search, printing the fills and their times.
+  const auto runPass = [&](std::string_view name, auto &&solve) {
+    std::vector<double> timesUs = {};
+    std::size_t solved = 0;
+    std::size_t matching = 0;
+    std::vector<std::uint32_t> ids = {};
+    std::vector<std::string_view> candidates = {};
+    for (const auto &level : levels) {
+      const auto start = Clock::now();
+      database.generateIds(level.letters, {}, ids);
+      candidates.clear();
+      for (const auto id : ids) {
+        candidates.push_back(database.entry(id).view);
+      }
+      const auto key = wsr::detail::LayoutKey::fromGrid(level.grid);
+      const wsr::detail::Crossword crossword(database.layoutAnalysis(*key), level.grid, candidates);
+      const auto fill = solve(crossword);
+      const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+
+      timesUs.push_back(elapsed.count());
+      if (!fill.has_value()) {
+        continue;
+      }
+      ++solved;
+      matching += normalized(*fill) == normalized(level.words);
+    }
+
+    std::cout << std::format(
+        "{}: {}/{} levels filled, {} matching the stored answers, "
+        "p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us per level\n",
+        name,
+        solved,
+        levels.size(),
+        matching,
+        percentile(timesUs, 0.5),
+        percentile(timesUs, 0.99),
+        percentile(timesUs, 1.0)
+    );
+  };
+
+  runPass("Serial search", [](const wsr::detail::Crossword &crossword) {
+    return crossword.solve();
+  });
+
+  // Tight deadlines keep the deepest partial fill, whose forced answers can be entered first.
+  for (const auto budget : {std::chrono::microseconds(20), std::chrono::microseconds(100)}) {
+    std::size_t complete = 0;
+    std::size_t answers = 0;
+    std::size_t forced = 0;
+    runPass(std::format("Anytime search ({} deadline)", budget), [&](const wsr::detail::Crossword &crossword) {
+      wsr::detail::SearchOptions options = {};
+      options.deadline = Clock::now() + budget;
+      const wsr::detail::CrosswordFill fill = crossword.solveAnytime(options);
+      complete += fill.complete;
+      for (std::size_t s = 0; s < fill.words.size(); ++s) {
+        answers += !fill.words[s].empty();
+        forced += crossword.candidateCount(s) == 1;
+      }
+      return fill.complete ? std::optional(fill.words) : std::nullopt;
+    });
+    std::cout << std::format(
+        "  {} complete, {:.2f} answers and {:.2f} forced answers per level\n",
+        complete,
+        double(answers) / double(std::max<std::size_t>(levels.size(), 1)),
+        double(forced) / double(std::max<std::size_t>(levels.size(), 1))
+    );
+  }
+
+  wsr::utils::ThreadPool pool(std::thread::hardware_concurrency());
+  runPass(std::format("Portfolio search ({} threads)", pool.size()), [&pool](const auto &crossword) {
+    return crossword.solveParallel(pool);
+  });
+}
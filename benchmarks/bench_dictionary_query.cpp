@@ -0,0 +1,195 @@
+/**
+ * bench_dictionary_query.cpp
+ *
+ * Compares the letter mask index against the linear dictionary scan
+ * for subset and equality queries over every level's letters in data.txt,
+ * top-k subset queries against full ones, and the batched signature kernel
+ * against Signature comparisons for every query type.
+ */
+
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The longest answer of each level uses all of its letters.
+std::vector<std::string> loadLetters(const fs::path &path) {
+  std::vector<std::string> letters = {};
+  std::ifstream stream(path);
+  std::string line = {};
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::size_t width = {};
+    std::size_t height = {};
+    std::string layout = {};
+    fields >> width >> height >> layout;
+
+    std::string longest = {};
+    std::string word = {};
+    while (fields >> word) {
+      longest = word.size() > longest.size() ? word : longest;
+    }
+    letters.push_back(std::move(longest));
+  }
+  return letters;
+}
+
+const char *typeName(wsr::detail::QueryType type) {
+  using wsr::detail::QueryType;
+  switch (type) {
+    case QueryType::QUERY_SUBSETS:
+      return "subsets";
+    case QueryType::QUERY_SUPERSETS:
+      return "supersets";
+    case QueryType::QUERY_EQUALITY:
+      return "equality";
+    case QueryType::QUERY_INEQUALITY:
+      return "inequality";
+  }
+  return "";
+}
+
+bool signatureMatches(
+    const wsr::detail::Signature &letters,
+    const wsr::detail::Signature &candidate,
+    wsr::detail::QueryType type
+) {
+  using wsr::detail::QueryType;
+  switch (type) {
+    case QueryType::QUERY_SUBSETS:
+      return letters >= candidate;
+    case QueryType::QUERY_SUPERSETS:
+      return letters <= candidate;
+    case QueryType::QUERY_EQUALITY:
+      return letters == candidate;
+    case QueryType::QUERY_INEQUALITY:
+      return letters != candidate;
+  }
+  return false;
+}
+
+bool sameEntries(
+    const std::vector<wsr::detail::DictionaryEntry> &a,
+    const std::vector<wsr::detail::DictionaryEntry> &b
+) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto &x, const auto &y) {
+    return x.view.data() == y.view.data();
+  });
+}
+
+}  // namespace
+
+int main() {
+  using wsr::detail::QueryStrategy;
+  using wsr::detail::QueryType;
+  const wsr::detail::Database database = {};
+  const std::vector<std::string> letters = loadLetters(wsr::utils::getRoot() / "data" / "data.txt");
+
+  for (const auto type : {QueryType::QUERY_SUBSETS, QueryType::QUERY_EQUALITY}) {
+    const auto timeQueries = [&](QueryStrategy strategy) {
+      std::size_t matches = 0;
+      const auto start = Clock::now();
+      for (const auto &query : letters) {
+        matches += database.query(query, type, strategy).size();
+      }
+      const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+      return std::pair(elapsed.count() / double(letters.size()), matches);
+    };
+    const auto [linearUs, linearMatches] = timeQueries(QueryStrategy::STRATEGY_LINEAR);
+    const auto [indexedUs, indexedMatches] = timeQueries(QueryStrategy::STRATEGY_AUTO);
+
+    std::size_t mismatches = 0;
+    for (const auto &query : letters) {
+      mismatches += !sameEntries(
+          database.query(query, type, QueryStrategy::STRATEGY_LINEAR),
+          database.query(query, type, QueryStrategy::STRATEGY_AUTO)
+      );
+    }
+
+    std::cout << std::format(
+        "{}: linear {:.1f} us/query, indexed {:.1f} us/query ({:.1f}x), "
+        "{} matches, {} mismatched queries\n",
+        typeName(type),
+        linearUs,
+        indexedUs,
+        linearUs / indexedUs,
+        indexedMatches,
+        mismatches
+    );
+    if (linearMatches != indexedMatches) {
+      std::cout << std::format("match counts differ: {} linear\n", linearMatches);
+    }
+  }
+
+  // The k most frequent words of each length must lead that length in a full query.
+  constexpr std::size_t topK = 10;
+  std::size_t topMatches = 0;
+  const auto topStart = Clock::now();
+  for (const auto &query : letters) {
+    topMatches += database.queryTop(query, QueryType::QUERY_SUBSETS, topK).size();
+  }
+  const std::chrono::duration<double, std::micro> topElapsed = Clock::now() - topStart;
+  std::size_t topMismatches = 0;
+  for (const auto &query : letters) {
+    auto expected = database.query(query, QueryType::QUERY_SUBSETS);
+    std::array<std::size_t, UINT8_MAX + 1> perLength = {};
+    std::erase_if(expected, [&perLength](const auto &entry) {
+      return ++perLength[entry.view.size()] > topK;
+    });
+    topMismatches += !sameEntries(expected, database.queryTop(query, QueryType::QUERY_SUBSETS, topK));
+  }
+  std::cout << std::format(
+      "subsets, top {} per length: {:.1f} us/query, {} matches, {} mismatched queries\n",
+      topK,
+      topElapsed.count() / double(letters.size()),
+      topMatches,
+      topMismatches
+  );
+
+  // Every dictionary entry differs from the empty string.
+  const auto entries = database.query("", QueryType::QUERY_INEQUALITY);
+  std::vector<wsr::detail::LetterCounts> counts = {};
+  for (const auto &entry : entries) {
+    counts.push_back(entry.signature.counts());
+  }
+  std::vector<std::uint8_t> matches(counts.size());
+  const std::size_t sampleCount = std::min<std::size_t>(letters.size(), 200);
+  for (const auto type : {
+           QueryType::QUERY_SUBSETS,
+           QueryType::QUERY_SUPERSETS,
+           QueryType::QUERY_EQUALITY,
+           QueryType::QUERY_INEQUALITY
+       }) {
+    std::size_t scalarMatches = 0;
+    const auto scalarStart = Clock::now();
+    for (std::size_t q = 0; q < sampleCount; ++q) {
+      const wsr::detail::Signature letterSig(letters[q]);
+      for (const auto &entry : entries) {
+        scalarMatches += signatureMatches(letterSig, entry.signature, type);
+      }
+    }
+    const std::chrono::duration<double, std::nano> scalarElapsed = Clock::now() - scalarStart;
+
+    std::size_t kernelMatches = 0;
+    const auto kernelStart = Clock::now();
+    for (std::size_t q = 0; q < sampleCount; ++q) {
+      wsr::detail::matchSignatures(wsr::detail::Signature(letters[q]).counts(), counts, type, matches);
+      kernelMatches += std::size_t(std::count(matches.begin(), matches.end(), 1));
+    }
+    const std::chrono::duration<double, std::nano> kernelElapsed = Clock::now() - kernelStart;
+
+    const double comparisons = double(sampleCount * entries.size());
+    std::cout << std::format(
+        "{} kernel: Signature {:.2f} ns/entry, batched {:.2f} ns/entry ({:.1f}x), {}\n",
+        typeName(type),
+        scalarElapsed.count() / comparisons,
+        kernelElapsed.count() / comparisons,
+        scalarElapsed.count() / kernelElapsed.count(),
+        scalarMatches == kernelMatches ? "same matches" : "MATCHES DIFFER"
+    );
+  }
+}
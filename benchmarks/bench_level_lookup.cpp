@@ -0,0 +1,109 @@
+/**
+ * bench_level_lookup.cpp
+ *
+ * Measures Database::query(grid, letters) over every level in data.txt,
+ * along with lookups of layouts that are not in the database,
+ * Database::queryNearest over the same layouts with one misread cell, and
+ * lookups of boards resumed with one answer already revealed.
+ */
+
+#include "bench_common.hpp"
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+using Clock = std::chrono::steady_clock;
+using wsr::bench::BenchLevel;
+using wsr::bench::loadLevels;
+
+int main() {
+  constexpr int repetitions = 20;
+  const wsr::detail::Database database = {};
+  const std::vector<BenchLevel> levels = loadLevels(wsr::utils::getRoot() / "data" / "data.txt");
+
+  std::size_t hits = 0;
+  std::size_t wrong = 0;
+  for (const auto &level : levels) {
+    const auto result = database.query(level.grid, level.letters);
+    if (!result.has_value()) {
+      continue;
+    }
+    ++hits;
+    wrong += !std::equal(
+        result->words.begin(), result->words.end(), level.words.begin(), level.words.end()
+    );
+  }
+
+  // Each layout with its first cell toggled, which is almost never stored.
+  std::vector<BenchLevel> misses = levels;
+  for (auto &level : misses) {
+    level.grid[{0, 0}] = level.grid[{0, 0}] == '0' ? '1' : '0';
+  }
+
+  const auto timeLookups = [&database](const std::vector<BenchLevel> &queries) {
+    std::size_t found = 0;
+    const auto start = Clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+      for (const auto &level : queries) {
+        found += database.query(level.grid, level.letters).has_value();
+      }
+    }
+    const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return std::pair(elapsed.count() / double(repetitions * queries.size()), found);
+  };
+  const auto [hitNs, hitFound] = timeLookups(levels);
+  const auto [missNs, missFound] = timeLookups(misses);
+
+  // Each board with its first slot revealed, trying answers until one is accepted.
+  std::size_t resumed = 0;
+  std::size_t resumeQueries = 0;
+  const auto resumeStart = Clock::now();
+  for (const auto &level : levels) {
+    const auto key = wsr::detail::LayoutKey::fromGrid(level.grid);
+    const std::vector<wsr::detail::Slot> slots = wsr::detail::findSlots(*key);
+    for (const auto &word : level.words) {
+      if (word.size() != slots.front().length) {
+        continue;
+      }
+      wsr::Matrix<char> grid = level.grid;
+      for (std::size_t i = 0; i < word.size(); ++i) {
+        grid[slots.front().cell(i)] = word[i];
+      }
+      ++resumeQueries;
+      const auto result = database.query(grid, level.letters);
+      if (result.has_value()) {
+        resumed += std::ranges::find(result->unsolved, word) == result->unsolved.end();
+        break;
+      }
+    }
+  }
+  const std::chrono::duration<double, std::nano> resumeElapsed = Clock::now() - resumeStart;
+
+  std::size_t recovered = 0;
+  const auto nearestStart = Clock::now();
+  for (std::size_t i = 0; i < misses.size(); ++i) {
+    const auto result = database.queryNearest(misses[i].grid, misses[i].letters, 1);
+    recovered += result.has_value() && std::equal(
+        result->words.begin(), result->words.end(), levels[i].words.begin(), levels[i].words.end()
+    );
+  }
+  const std::chrono::duration<double, std::nano> nearestElapsed = Clock::now() - nearestStart;
+
+  std::cout << std::format("levels: {}, hits: {}, wrong answers: {}\n", levels.size(), hits, wrong);
+  std::cout << std::format("stored layouts: {:.1f} ns/lookup\n", hitNs);
+  std::cout << std::format(
+      "unknown layouts: {:.1f} ns/lookup ({} found)\n", missNs, missFound / repetitions
+  );
+  std::cout << std::format(
+      "misread layouts (nearest, 1 cell): {:.1f} ns/lookup, {} of {} recovered\n",
+      nearestElapsed.count() / double(misses.size()),
+      recovered,
+      misses.size()
+  );
+  std::cout << std::format(
+      "revealed answers: {:.1f} ns/lookup, {} of {} resumed\n",
+      resumeElapsed.count() / double(resumeQueries),
+      resumed,
+      levels.size()
+  );
+}
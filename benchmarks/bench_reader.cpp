@@ -0,0 +1,155 @@
+/**
+ * bench_reader.cpp
+ *
+ * Measures Reader::match and Reader::matchGrayscale over glyphs rendered from
+ * the letter templates at a few screen sizes, on both light and dark
+ * backgrounds, with and without noise. Also times a plain per-pixel grayscale
+ * comparison against the same templates, as the baseline the grayscale
+ * kernels replace, and grayscale matching without the cascade, which must
+ * give the same results as with it. Binary glyphs repeat every round, so
+ * after the first round they are read from the glyph cache.
+ */
+
+#include "core/pch.hpp"
+#include "core/reader.hpp"
+#include "utils/utilities.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct BenchGlyph {
+  cv::Mat image = {};
+  char letter = {};
+};
+
+// Adds deterministic noise of up to the given amplitude to every pixel.
+cv::Mat addNoise(const cv::Mat &image, int amplitude, std::uint32_t &seed) {
+  cv::Mat noisy = image.clone();
+  for (int y = 0; y < noisy.rows; ++y) {
+    for (int x = 0; x < noisy.cols; ++x) {
+      seed = seed * 1664525U + 1013904223U;
+      const int offset = int(seed >> 24) % (2 * amplitude + 1) - amplitude;
+      auto &pixel = noisy.at<std::uint8_t>(y, x);
+      pixel = std::uint8_t(std::clamp(pixel + offset, 0, int(UINT8_MAX)));
+    }
+  }
+  return noisy;
+}
+
+std::vector<BenchGlyph> loadGlyphs(std::vector<cv::Mat> &templates) {
+  constexpr std::array<int, 3> sides = {24, 45, 64};
+  constexpr int noise = 96;
+  std::uint32_t seed = 1;
+  std::vector<BenchGlyph> glyphs = {};
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    const auto path = wsr::utils::getRoot() / "data" / "templates" / std::format("{}.png", c);
+    cv::Mat gray = cv::imread(path.string(), cv::IMREAD_GRAYSCALE);
+    templates.push_back(gray);
+    for (const int side : sides) {
+      cv::Mat resized = {};
+      cv::resize(gray, resized, cv::Size(side, side));
+      cv::Mat inverted = {};
+      cv::bitwise_not(resized, inverted);
+      glyphs.push_back({resized, c});
+      glyphs.push_back({inverted, c});
+      glyphs.push_back({addNoise(resized, noise, seed), c});
+      glyphs.push_back({addNoise(inverted, noise, seed), c});
+    }
+  }
+  return glyphs;
+}
+
+// Per-pixel distances to every template and its inverse, as matched before the atlas.
+char matchScalar(const cv::Mat &image, const std::vector<cv::Mat> &templates) {
+  cv::Mat roi = {};
+  cv::resize(image, roi, templates.front().size());
+  char best = 'A';
+  int bestDiff = INT_MAX;
+  for (std::size_t i = 0; i < templates.size(); ++i) {
+    int diff = 0;
+    int invDiff = 0;
+    for (int y = 0; y < roi.rows; ++y) {
+      for (int x = 0; x < roi.cols; ++x) {
+        const int p = roi.at<std::uint8_t>(y, x);
+        const int t = templates[i].at<std::uint8_t>(y, x);
+        diff += std::abs(p - t);
+        invDiff += std::abs(p - (UINT8_MAX - t));
+      }
+    }
+    if (std::min(diff, invDiff) < bestDiff) {
+      bestDiff = std::min(diff, invDiff);
+      best = char('A' + i);
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+int main() {
+  constexpr int repetitions = 200;
+  wsr::Reader reader = {};
+  std::vector<cv::Mat> templates = {};
+  const std::vector<BenchGlyph> glyphs = loadGlyphs(templates);
+
+  const auto time = [&glyphs](auto &&read) {
+    std::size_t misreads = 0;
+    const auto start = Clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+      for (const auto &glyph : glyphs) {
+        misreads += read(glyph.image) != glyph.letter;
+      }
+    }
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return std::pair(elapsed.count() / double(repetitions * glyphs.size()), misreads / repetitions);
+  };
+
+  const auto whole = [](const cv::Mat &image) { return cv::Rect(0, 0, image.cols, image.rows); };
+  const auto [binaryTime, binaryMisreads] = time([&](const cv::Mat &image) {
+    return reader.match(image, whole(image)).second;
+  });
+  const auto [grayTime, grayMisreads] = time([&](const cv::Mat &image) {
+    return reader.matchGrayscale(image, whole(image)).second;
+  });
+  reader.setCascade(false);
+  const auto [exhaustiveTime, exhaustiveMisreads] = time([&](const cv::Mat &image) {
+    return reader.matchGrayscale(image, whole(image)).second;
+  });
+
+  // Any difference between the cascade and the exhaustive match is a bug.
+  std::size_t mismatches = 0;
+  for (const auto &glyph : glyphs) {
+    const cv::Rect bbox = whole(glyph.image);
+    reader.setCascade(false);
+    const auto exhaustive = reader.matchGrayscale(glyph.image, bbox);
+    reader.setCascade(true);
+    mismatches += reader.matchGrayscale(glyph.image, bbox) != exhaustive;
+  }
+  const auto [scalarTime, scalarMisreads] = time([&](const cv::Mat &image) {
+    return matchScalar(image, templates);
+  });
+
+  std::cout << std::format("{} glyphs, AVX2 {}\n", glyphs.size(), wsr::utils::cpuSupportsAvx2());
+  const wsr::GlyphCacheStats cacheStats = reader.glyphCacheStats();
+  std::cout << std::format(
+      "binary match     {:8.2f} us/glyph, {} misread, {} cache hits, {} misses\n",
+      binaryTime,
+      binaryMisreads,
+      cacheStats.hits,
+      cacheStats.misses
+  );
+  std::cout << std::format(
+      "grayscale match  {:8.2f} us/glyph, {} misread\n", grayTime, grayMisreads
+  );
+  std::cout << std::format(
+      "  no cascade     {:8.2f} us/glyph, {} misread, {} differ\n",
+      exhaustiveTime,
+      exhaustiveMisreads,
+      mismatches
+  );
+  std::cout << std::format(
+      "scalar grayscale {:8.2f} us/glyph, {} misread\n", scalarTime, scalarMisreads
+  );
+  return int(mismatches);
+}
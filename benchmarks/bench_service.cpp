@@ -0,0 +1,90 @@
+/**
+ * bench_service.cpp
+ *
+ * Starts a SolverService in process and solves every level in data.txt through
+ * it from N concurrent clients, given as the first argument and defaulting to
+ * every hardware thread. Reports the round trip times against solving in
+ * process, and how many responses spell the stored answers.
+ */
+
+#include "bench_common.hpp"
+#include "core/pch.hpp"
+#include "core/service.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+using wsr::bench::BenchLevel;
+using wsr::bench::loadLevels;
+using wsr::bench::percentile;
+
+int main(int argc, char **argv) {
+  const std::size_t clientCount =
+      argc > 1 ? std::size_t(std::max(1, std::atoi(argv[1])))
+               : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const std::vector<BenchLevel> levels = loadLevels(wsr::utils::getRoot() / "data" / "data.txt");
+
+  const auto socketPath = fs::temp_directory_path() / "wordscraper_bench.sock";
+  wsr::SolverService service(socketPath, clientCount);
+  std::thread server([&service] { service.run(); });
+
+  std::vector<double> roundTripUs(levels.size());
+  std::vector<bool> matching(levels.size());
+  std::atomic<std::size_t> next = 0;
+  const auto start = Clock::now();
+  {
+    std::vector<std::jthread> clients = {};
+    for (std::size_t c = 0; c < clientCount; ++c) {
+      clients.emplace_back([&] {
+        wsr::SolverClient client(socketPath);
+        for (std::size_t i = next++; i < levels.size(); i = next++) {
+          const auto requestStart = Clock::now();
+          const std::vector<wsr::detail::WheelPath> paths = client.solve(levels[i].grid, levels[i].letters);
+          const std::chrono::duration<double, std::micro> elapsed = Clock::now() - requestStart;
+          roundTripUs[i] = elapsed.count();
+
+          std::vector<std::string> words = {};
+          for (const auto &path : paths) {
+            std::string &word = words.emplace_back();
+            for (const auto position : path) {
+              word.push_back(levels[i].letters[position]);
+            }
+          }
+          std::vector<std::string> answers = levels[i].words;
+          std::sort(words.begin(), words.end());
+          std::sort(answers.begin(), answers.end());
+          matching[i] = words == answers;
+        }
+      });
+    }
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  service.stop();
+  server.join();
+
+  const wsr::Solver solver = {};
+  std::vector<double> inProcessUs = {};
+  for (const auto &level : levels) {
+    const auto solveStart = Clock::now();
+    std::ignore = solver.solve(level.grid, level.letters);
+    const std::chrono::duration<double, std::micro> solveElapsed = Clock::now() - solveStart;
+    inProcessUs.push_back(solveElapsed.count());
+  }
+
+  std::cout << std::format(
+      "Service ({} clients): {:.0f} levels/s, round trip p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us, "
+      "{}/{} levels matching\n",
+      clientCount,
+      double(levels.size()) / elapsed.count(),
+      percentile(roundTripUs, 0.5),
+      percentile(roundTripUs, 0.99),
+      percentile(roundTripUs, 1.0),
+      std::ranges::count(matching, true),
+      levels.size()
+  );
+  std::cout << std::format(
+      "In process: p50 {:.1f} us, p99 {:.1f} us per level\n",
+      percentile(inProcessUs, 0.5),
+      percentile(inProcessUs, 0.99)
+  );
+}
@@ -0,0 +1,111 @@
+/**
+ * bench_solve_session.cpp
+ *
+ * Plays every level in data.txt through a SolveSession that only knows the
+ * dictionary, as if none of the levels were stored. Each suggested word is
+ * accepted when it is an answer, revealing its letters, and rejected otherwise.
+ * Reports the swipes per level under each guess policy, and the time per move
+ * against rebuilding and searching the crossword from scratch every move.
+ */
+
+#include "bench_common.hpp"
+#include "core/crossword.hpp"
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+using Clock = std::chrono::steady_clock;
+using wsr::bench::BenchLevel;
+using wsr::bench::loadLevels;
+using wsr::bench::percentile;
+
+int main() {
+  const wsr::detail::Database database = {};
+  const std::vector<BenchLevel> levels = loadLevels(wsr::utils::getRoot() / "data" / "data.txt");
+
+  std::vector<std::uint32_t> ids = {};
+  std::vector<std::string_view> candidates = {};
+  const auto playLevels = [&](std::string_view name, wsr::GuessPolicy policy) {
+    std::size_t played = 0;
+    std::size_t finished = 0;
+    std::size_t moves = 0;
+    std::size_t rejected = 0;
+    std::vector<double> moveUs = {};
+    std::vector<double> resolveUs = {};
+    for (const auto &level : levels) {
+      const auto key = wsr::detail::LayoutKey::fromGrid(level.grid);
+      const wsr::detail::LayoutAnalysis layout = database.layoutAnalysis(*key);
+      const std::vector<std::string_view> answers(level.words.begin(), level.words.end());
+
+      // Where the game places each answer.
+      const auto placement = wsr::detail::Crossword(layout, level.grid, answers).solve();
+      if (!placement.has_value()) {
+        continue;
+      }
+      ++played;
+
+      wsr::Matrix<char> grid = level.grid;
+      wsr::SolveSession session(database, grid, level.letters);
+      session.setGuessPolicy(policy);
+      std::vector<bool> solved(layout.slots.size());
+      const std::size_t maxMoves = 16 * layout.slots.size();
+      for (std::size_t move = 0; move < maxMoves; ++move) {
+        const auto start = Clock::now();
+        const auto next = session.nextWord();
+        if (!next.has_value()) {
+          break;
+        }
+        std::size_t slot = layout.slots.size();
+        for (std::size_t s = 0; s < layout.slots.size(); ++s) {
+          slot = !solved[s] && wsr::utils::equalsIgnoreCase((*placement)[s], next->word) ? s : slot;
+        }
+        if (slot == layout.slots.size()) {
+          session.wordRejected(next->word);
+          ++rejected;
+        } else {
+          session.wordAccepted(next->word);
+          solved[slot] = true;
+          for (std::size_t i = 0; i < layout.slots[slot].length; ++i) {
+            const wsr::Point cell = layout.slots[slot].cell(i);
+            grid[cell] = (*placement)[slot][i];
+            session.cellRevealed(cell, grid[cell]);
+          }
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        moveUs.push_back(elapsed.count());
+        ++moves;
+
+        // The same board re-solved from scratch, for comparison.
+        const auto resolveStart = Clock::now();
+        database.generateIds(level.letters, {}, ids);
+        candidates.clear();
+        for (const auto id : ids) {
+          candidates.push_back(database.entry(id).view);
+        }
+        const wsr::detail::Crossword crossword(layout, grid, candidates);
+        std::ignore = crossword.solveAnytime({});
+        const std::chrono::duration<double, std::micro> resolveElapsed = Clock::now() - resolveStart;
+        resolveUs.push_back(resolveElapsed.count());
+      }
+      finished += std::ranges::all_of(solved, [](bool s) { return s; });
+    }
+
+    std::cout << std::format(
+        "{}: {}/{} levels finished, {:.2f} swipes and {:.2f} rejected words per level, "
+        "p50 {:.1f} us, p99 {:.1f} us per move, "
+        "re-solve from scratch p50 {:.1f} us, p99 {:.1f} us\n",
+        name,
+        finished,
+        played,
+        double(moves) / double(std::max<std::size_t>(played, 1)),
+        double(rejected) / double(std::max<std::size_t>(played, 1)),
+        percentile(moveUs, 0.5),
+        percentile(moveUs, 0.99),
+        percentile(resolveUs, 0.5),
+        percentile(resolveUs, 0.99)
+    );
+  };
+
+  playLevels("Surest fill answer", wsr::GuessPolicy::POLICY_SUREST_FILL);
+  playLevels("Expected cost", wsr::GuessPolicy::POLICY_EXPECTED_COST);
+}
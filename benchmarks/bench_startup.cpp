@@ -0,0 +1,64 @@
+/**
+ * bench_startup.cpp
+ *
+ * Measures database startup time when compiling the text sources on
+ * 1 to N threads, and when mapping a prebuilt snapshot.
+ */
+
+#include "core/pch.hpp"
+#include "core/snapshot.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int repetitions = 5;
+
+template <typename F>
+double bestOf(F &&function) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < repetitions; ++i) {
+    const auto start = Clock::now();
+    function();
+    const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path dataDirectory = wsr::utils::getRoot() / "data";
+  const std::size_t maxThreads = std::max(1U, std::thread::hardware_concurrency());
+
+  std::vector<std::size_t> threadCounts = {};
+  for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  std::cout << std::format("{:>8} {:>12} {:>8}\n", "threads", "compile ms", "speedup");
+  double baseline = {};
+  std::vector<std::byte> image = {};
+  for (const auto threads : threadCounts) {
+    const double elapsed = bestOf([&] {
+      image = wsr::detail::Database::compile(dataDirectory, threads);
+    });
+    baseline = threads == 1 ? elapsed : baseline;
+    std::cout << std::format("{:>8} {:>12.2f} {:>7.2f}x\n", threads, elapsed, baseline / elapsed);
+  }
+
+  // A directory holding only the snapshot, so it is used without a freshness check.
+  const fs::path snapshotDirectory = fs::temp_directory_path() / "wsr_bench_startup";
+  fs::create_directories(snapshotDirectory);
+  wsr::detail::writeSnapshot(snapshotDirectory / wsr::detail::Database::snapshotFileName, image);
+  const double mapped = bestOf([&] {
+    const wsr::detail::Database database(snapshotDirectory);
+  });
+  std::cout << std::format("{:>8} {:>12.2f} {:>7.2f}x\n", "mapped", mapped, baseline / mapped);
+  fs::remove_all(snapshotDirectory);
+}
@@ -0,0 +1,103 @@
+/**
+ * bench_word_generation.cpp
+ *
+ * Compares Database::generate over the dictionary word graph against
+ * subset queries, scanned and indexed, for the 3 to 8 letter wheels in data.txt.
+ */
+
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr std::size_t minWheel = 3;
+constexpr std::size_t maxWheel = 8;
+
+// The longest answer of each level uses all of its letters.
+std::vector<std::vector<std::string>> loadWheels(const fs::path &path) {
+  std::vector<std::vector<std::string>> wheels(maxWheel + 1);
+  std::ifstream stream(path);
+  std::string line = {};
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::size_t width = {};
+    std::size_t height = {};
+    std::string layout = {};
+    fields >> width >> height >> layout;
+
+    std::string longest = {};
+    std::string word = {};
+    while (fields >> word) {
+      longest = word.size() > longest.size() ? word : longest;
+    }
+    if (longest.size() >= minWheel && longest.size() <= maxWheel) {
+      wheels[longest.size()].push_back(std::move(longest));
+    }
+  }
+  return wheels;
+}
+
+std::vector<std::string_view> distinctWords(const std::vector<wsr::detail::DictionaryEntry> &entries) {
+  std::vector<std::string_view> words = {};
+  for (const auto &entry : entries) {
+    words.push_back(entry.view);
+  }
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  return words;
+}
+
+}  // namespace
+
+int main() {
+  using wsr::detail::QueryStrategy;
+  using wsr::detail::QueryType;
+  const wsr::detail::Database database = {};
+  const auto wheels = loadWheels(wsr::utils::getRoot() / "data" / "data.txt");
+
+  for (std::size_t size = minWheel; size <= maxWheel; ++size) {
+    const auto &letters = wheels[size];
+    if (letters.empty()) {
+      continue;
+    }
+    const auto timeQueries = [&letters](auto &&query) {
+      std::size_t matches = 0;
+      const auto start = Clock::now();
+      for (const auto &wheel : letters) {
+        matches += query(wheel).size();
+      }
+      const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+      return std::pair(elapsed.count() / double(letters.size()), matches);
+    };
+    const auto [linearUs, linearMatches] = timeQueries([&database](const std::string &wheel) {
+      return database.query(wheel, QueryType::QUERY_SUBSETS, QueryStrategy::STRATEGY_LINEAR);
+    });
+    const auto [indexedUs, indexedMatches] = timeQueries([&database](const std::string &wheel) {
+      return database.query(wheel, QueryType::QUERY_SUBSETS);
+    });
+    const auto [graphUs, graphMatches] = timeQueries([&database](const std::string &wheel) {
+      return database.generate(wheel);
+    });
+
+    std::size_t mismatches = 0;
+    for (const auto &wheel : letters) {
+      mismatches += distinctWords(database.query(wheel, QueryType::QUERY_SUBSETS)) !=
+                    distinctWords(database.generate(wheel));
+    }
+    std::cout << std::format(
+        "{} letters ({} wheels): linear {:.1f} us, indexed {:.1f} us, word graph {:.1f} us "
+        "per query, {} matches, {} mismatched wheels\n",
+        size,
+        letters.size(),
+        linearUs,
+        indexedUs,
+        graphUs,
+        graphMatches / letters.size(),
+        mismatches
+    );
+  }
+}
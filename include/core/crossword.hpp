@@ -0,0 +1,204 @@
+/**
+ * crossword.hpp
+ *
+ * Declaration for the Crossword class.
+ */
+
+#pragma once
+
+#include "core/layout.hpp"
+#include "core/pch.hpp"
+#include "core/types.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace wsr::detail {
+
+// Which unassigned slot a search fills next.
+enum class SlotOrder : std::uint8_t {
+  ORDER_FEWEST_CANDIDATES,  // Minimum remaining values.
+  ORDER_MOST_CROSSINGS,     // Fewest candidates, ties broken by most open crossings.
+  ORDER_LONGEST,            // Longest slot, ties broken by fewest candidates.
+};
+
+// Which candidate of a slot a search tries first.
+enum class CandidateOrder : std::uint8_t {
+  ORDER_FREQUENCY,  // The order the words were given in.
+  ORDER_RANDOM,     // Shuffled by the search seed.
+};
+
+struct SearchOptions {
+  SlotOrder slotOrder = SlotOrder::ORDER_FEWEST_CANDIDATES;
+  CandidateOrder candidateOrder = CandidateOrder::ORDER_FREQUENCY;
+  std::size_t maxNodes = 100000;
+
+  // Breaks slot ties at random when non-zero, and seeds ORDER_RANDOM.
+  std::uint64_t seed = {};
+
+  // Stops the search once set, if given.
+  const std::atomic<bool> *cancelled = nullptr;
+
+  // Stops the search once passed.
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+// A candidate of a slot with its chance of being the slot's answer.
+struct RankedCandidate {
+  std::string_view word = {};
+  double probability = {};
+};
+
+// Result of a search that may stop before every slot is filled.
+struct CrosswordFill {
+  std::vector<std::string_view> words = {};  // Per slot, empty where the search stopped short.
+  bool complete = {};
+};
+
+/**
+ * Constraint satisfaction model of a grid. Every slot has a bitset domain over
+ * the candidate words of its length, pruned by the letters revealed on the grid
+ * and kept arc consistent over crossings. Solving runs backtracking that fills
+ * the slot with the fewest candidates first, trying candidates in the order given.
+ */
+class Crossword {
+ public:
+  static constexpr std::size_t defaultMaxNodes = SearchOptions{}.maxNodes;
+
+ private:
+  using Domains = std::vector<std::uint64_t>;
+
+  struct SearchState {
+    const SearchOptions &options;
+    std::mt19937_64 random;
+    std::size_t nodes = {};
+    bool expired = {};
+
+    // The consistent partial fill with the most filled slots so far.
+    std::size_t deepest = {};
+    Domains deepestDomains = {};
+    std::vector<bool> deepestAssigned = {};
+  };
+
+  LayoutAnalysis layout_ = {};
+
+  // Candidates and their letter bitsets, by word length.
+  std::vector<std::vector<std::string_view>> lengthWords_ = {};
+  std::vector<std::vector<std::uint64_t>> letterBits_ = {};
+  std::vector<std::vector<std::size_t>> lengthFrequencies_ = {};  // Empty without frequencies.
+
+  std::vector<std::uint32_t> domainsBegin_ = {};  // Per slot, plus an end.
+  Domains domains_ = {};
+  bool consistent_ = {};
+
+  std::size_t blockCount_(std::size_t slot) const noexcept;
+  std::span<std::uint64_t> domain_(Domains &domains, std::size_t slot) const noexcept;
+
+  // Candidates of a length holding a letter at a position.
+  std::span<const std::uint64_t> candidatesWith_(
+      std::size_t length, std::size_t position, std::size_t letter
+  ) const noexcept;
+
+  // Removes candidates of a slot without support in a crossing slot.
+  // Returns whether the domain changed.
+  bool revise_(Domains &domains, std::size_t slot, const Crossing &crossing) const noexcept;
+
+  // Restores arc consistency after the domains of the given slots changed.
+  // Returns false once a domain is wiped out.
+  bool propagate_(Domains &domains, std::span<const std::uint32_t> changed) const;
+
+  // Narrows a slot to one candidate, which leaves every other slot of its length.
+  // Writes the slots it changed. Returns false once a domain is wiped out.
+  bool assign_(
+      Domains &domains, std::size_t slot, std::size_t word, std::vector<std::uint32_t> &changed
+  ) const;
+
+  // Index of a word among the candidates of its length, ignoring case,
+  // or std::numeric_limits<std::size_t>::max() if it is not a candidate.
+  std::size_t candidateIndex_(std::size_t length, std::string_view word) const noexcept;
+
+  // Unnormalized chance of a candidate, given its index among the candidates of its
+  // length and its frequency rank in a slot.
+  double prior_(std::size_t length, std::size_t index, std::size_t rank) const noexcept;
+
+  // Picks the next slot to fill, or slots().size() once every slot is filled.
+  std::size_t nextSlot_(
+      Domains &domains, const std::vector<bool> &assigned, SearchState &state
+  ) const;
+  bool search_(Domains &domains, std::vector<bool> &assigned, SearchState &state) const;
+  bool stopped_(SearchState &state) const noexcept;
+
+  // Runs one search from the propagated domains, leaving the fill in domains.
+  // Sets exhausted when the search proved that no fill exists.
+  bool run_(const SearchOptions &options, Domains &domains, bool &exhausted) const;
+  bool run_(SearchState &state, Domains &domains, bool &exhausted) const;
+
+  // Maps every slot's remaining candidate to its word.
+  std::string_view firstCandidate_(Domains &domains, std::size_t slot) const noexcept;
+  std::vector<std::string_view> fill_(Domains &domains) const;
+
+ public:
+  // Builds the model from the analysis of the grid's layout, the grid of '0', '1'
+  // or revealed letters and the words that may fill it, ordered from most to least
+  // likely. Frequencies, if given, are per word. The analysis must outlive the model.
+  Crossword(
+      const LayoutAnalysis &layout,
+      const Matrix<char> &grid,
+      std::span<const std::string_view> words,
+      std::span<const std::size_t> frequencies = {}
+  );
+
+  std::span<const Slot> slots() const noexcept;
+  std::span<const Crossing> crossingsOf(std::size_t slot) const noexcept;
+
+  // Checks if arc consistency left every slot with a candidate.
+  bool consistent() const noexcept;
+
+  // Number of candidates left for a slot after propagation.
+  std::size_t candidateCount(std::size_t slot) const noexcept;
+
+  // Number of candidates left for a slot holding the letter at a position.
+  std::size_t supportCount(std::size_t slot, std::size_t position, char letter) const noexcept;
+
+  // Checks if a word, ignoring case, is still a candidate of a slot.
+  bool hasCandidate(std::size_t slot, std::string_view word) const noexcept;
+
+  // Narrows the slots through a cell to candidates showing the letter there.
+  // Returns false once the grid cannot be filled anymore.
+  bool reveal(Point cell, char letter);
+
+  // Narrows a slot to the word. Returns false once the grid cannot be filled anymore.
+  bool assign(std::size_t slot, std::string_view word);
+
+  // Removes a word, ignoring case, from every slot. Returns false once the grid
+  // cannot be filled anymore.
+  bool exclude(std::string_view word);
+
+  // Returns the word of every slot, in slot order, or std::nullopt if no
+  // assignment exists within the node budget. Slots never share a word.
+  std::optional<std::vector<std::string_view>> solve(const SearchOptions &options = {}) const;
+
+  // Same as solve above, but stops at the deadline or node budget with the deepest
+  // partial fill found, keeping every slot it filled or left with a single candidate.
+  CrosswordFill solveAnytime(const SearchOptions &options) const;
+
+  // Number of candidates of a slot, left after propagation, that were given before
+  // the word. Zero is the most frequent candidate.
+  std::size_t frequencyRank(std::size_t slot, std::string_view word) const noexcept;
+
+  // Chance of the word being the slot's answer, proportional to its frequency when
+  // frequencies were given, and under a Zipf prior by frequency rank otherwise.
+  // A candidate forced by the grid is certain.
+  double confidence(std::size_t slot, std::string_view word) const noexcept;
+
+  // Writes the candidates left for a slot with their confidence, most frequent first.
+  void rankCandidates(std::size_t slot, std::vector<RankedCandidate> &candidates) const;
+
+  // Same as solve above, but races a portfolio of differently ordered searches on
+  // the pool: frequency-first searches under each slot order, and searches with
+  // shuffled candidates restarted under growing node budgets. The first fill found
+  // cancels the others. Each search is bounded by maxNodes.
+  std::optional<std::vector<std::string_view>> solveParallel(
+      utils::ThreadPool &pool, std::size_t maxNodes = defaultMaxNodes
+  ) const;
+};
+
+}  // namespace wsr::detail
@@ -0,0 +1,68 @@
+/**
+ * dawg.hpp
+ *
+ * Declaration for the Dawg class.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace wsr::detail {
+
+struct DawgNode {
+  std::uint32_t edgesBegin = {};  // Index into the edge table, ending at the next node's.
+  std::uint32_t wordCount = {};   // Words spelled by the paths leaving this node.
+};
+
+struct DawgEdge {
+  // Transition packed as (target << 6) | (final << 5) | letter.
+  // A final edge completes a word with its letter.
+  std::uint32_t transition = {};
+
+  // Words spelled through the node's earlier edges, so skipped
+  // edges never touch their targets.
+  std::uint32_t rankOffset = {};
+};
+
+struct WordFilter {
+  std::size_t minLength = 1;
+  std::size_t maxLength = std::numeric_limits<std::size_t>::max();
+
+  // Letters fixed by position, with any other character left open.
+  // A non-empty pattern also fixes the word length.
+  std::string_view pattern = {};
+};
+
+/**
+ * Minimal deterministic acyclic word graph over a sorted set of words,
+ * numbering each word by its lexicographic rank. The node and edge
+ * tables are viewed, never copied.
+ */
+class Dawg {
+  std::span<const DawgNode> nodes_ = {};
+  std::span<const DawgEdge> edges_ = {};
+
+ public:
+  Dawg() = default;
+  Dawg(std::span<const DawgNode> nodes, std::span<const DawgEdge> edges);
+
+  // Number of words in the graph.
+  std::size_t size() const noexcept;
+
+  // Appends the rank of every word that can be spelled from the letters, using
+  // each letter at most as often as it occurs, and that passes the filter.
+  // Ranks are appended in ascending order.
+  void generate(
+      std::string_view letters, const WordFilter &filter, std::vector<std::uint32_t> &ranks
+  ) const;
+
+  // Builds the graph with Daciuk's incremental algorithm. Words must be
+  // alphabetic, distinct and sorted case-insensitively.
+  // The returned tables must outlive any Dawg viewing them.
+  static std::pair<std::vector<DawgNode>, std::vector<DawgEdge>> build(
+      std::span<const std::string_view> words
+  );
+};
+
+}  // namespace wsr::detail
@@ -0,0 +1,136 @@
+/**
+ * layout.hpp
+ *
+ * Declaration for grid layout keys.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+#include "core/types.hpp"
+
+namespace wsr::detail {
+
+// Checks if a grid cell holds a tile, revealed or not.
+constexpr bool isOccupied(char cell) noexcept {
+  return cell != '0' && cell != '\0';
+}
+
+// Checks if a grid cell shows an already solved letter.
+constexpr bool isRevealed(char cell) noexcept {
+  const char upper = char(cell & ~0x20);
+  return upper >= 'A' && upper <= 'Z';
+}
+
+/**
+ * Exact, bit-packed cell occupancy of a grid layout.
+ * Bit (y * width + x) is set when the cell holds a tile.
+ */
+struct LayoutKey {
+  static constexpr std::size_t maxCells = 256;
+  static constexpr std::size_t wordBits = 64;
+  static constexpr std::size_t wordCount = maxCells / wordBits;
+
+  std::uint8_t width = {};
+  std::uint8_t height = {};
+  std::array<std::uint8_t, 6> padding = {};
+  std::array<std::uint64_t, wordCount> bits = {};
+
+  bool operator==(const LayoutKey &rhs) const noexcept = default;
+
+  // Returns std::nullopt if the grid does not fit in a key.
+  static std::optional<LayoutKey> fromGrid(const Matrix<char> &grid) noexcept;
+
+  // Builds a key from a row-major string of '0' and '1' cells.
+  static std::optional<LayoutKey> fromString(
+      std::size_t width, std::size_t height, std::string_view layout
+  ) noexcept;
+
+  std::uint64_t hash() const noexcept;
+
+  bool occupied(std::size_t x, std::size_t y) const noexcept {
+    WSR_ASSERT(x < width && y < height);
+    const std::size_t bit = y * width + x;
+    return (bits[bit / wordBits] >> (bit % wordBits)) & 1U;
+  }
+};
+
+/**
+ * A maximal horizontal or vertical run of at least two tiles,
+ * which holds exactly one answer.
+ */
+struct Slot {
+  std::uint8_t x = {};
+  std::uint8_t y = {};
+  std::uint8_t length = {};
+  bool vertical = {};
+
+  Point cell(std::size_t i) const noexcept {
+    WSR_ASSERT(i < length);
+    return {x + int(vertical ? 0 : i), y + int(vertical ? i : 0)};
+  }
+};
+
+// Returns every slot of a layout, horizontal slots first, in row-major order.
+std::vector<Slot> findSlots(const LayoutKey &key);
+
+// A cell shared by two slots, listed once under each of them.
+struct Crossing {
+  std::uint32_t slot = {};          // The crossing slot.
+  std::uint32_t reverse = {};       // The same cell in the crossing slot's list.
+  std::uint8_t position = {};       // Shared cell index inside this slot.
+  std::uint8_t otherPosition = {};  // Shared cell index inside the crossing slot.
+  std::array<std::uint8_t, 2> padding = {};
+};
+
+struct LayoutStructure;
+
+/**
+ * Slots of a layout and the cells where they cross, viewed either from
+ * a snapshot or from a memoized LayoutStructure. Crossing::slot and
+ * Crossing::reverse index the slots and crossings of this layout only.
+ */
+struct LayoutAnalysis {
+  std::span<const Slot> slots = {};
+  std::span<const Crossing> crossings = {};
+  std::span<const std::uint32_t> crossingsBegin = {};  // Per slot, plus an end.
+  std::shared_ptr<const LayoutStructure> owner = {};   // Keeps memoized views alive, if any.
+
+  std::span<const Crossing> crossingsOf(std::size_t slot) const noexcept {
+    WSR_ASSERT(slot < slots.size());
+    const std::size_t begin = crossingsBegin[slot] - crossingsBegin.front();
+    return crossings.subspan(begin, crossingsBegin[slot + 1] - crossingsBegin[slot]);
+  }
+};
+
+// Owning storage of a layout analysis.
+struct LayoutStructure {
+  std::vector<Slot> slots = {};
+  std::vector<Crossing> crossings = {};
+  std::vector<std::uint32_t> crossingsBegin = {};
+
+  LayoutAnalysis view() const noexcept {
+    return {slots, crossings, crossingsBegin};
+  }
+};
+
+// Finds the slots of a layout and their crossings.
+LayoutStructure analyzeLayout(const LayoutKey &key);
+
+struct LayoutKeyHash {
+  std::size_t operator()(const LayoutKey &key) const noexcept {
+    return std::size_t(key.hash());
+  }
+};
+
+using LayoutBits = std::array<std::uint64_t, LayoutKey::wordCount>;
+
+/**
+ * Writes the number of differing cells between a layout and every candidate.
+ * Uses AVX2 when the processor supports it.
+ */
+void hammingDistances(
+    const LayoutBits &layout, std::span<const LayoutBits> candidates, std::span<std::uint16_t> out
+) noexcept;
+
+}  // namespace wsr::detail
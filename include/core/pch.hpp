@@ -52,6 +52,10 @@
   #define NOMCX             // Modem Configuration Extensions
   #define WIN32_LEAN_AND_MEAN
   #include <Windows.h>
+  #include <winsock2.h>
+  #include <afunix.h>
+  #include <immintrin.h>
+  #include <intrin.h>
 #else
   #error Windows (x64) compilation target required.
 #endif
@@ -66,17 +70,21 @@
 #include <charconv>
 #include <chrono>
 #include <climits>
+#include <cmath>
 #include <concepts>
 #include <condition_variable>
 #include <unordered_map>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -84,12 +92,16 @@
 #include <numeric>
 #include <numbers>
 #include <optional>
+#include <random>
+#include <shared_mutex>
 #include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
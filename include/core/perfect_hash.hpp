@@ -0,0 +1,44 @@
+/**
+ * perfect_hash.hpp
+ *
+ * Declaration for the PerfectHash class.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace wsr::detail {
+
+struct PerfectHashParams {
+  std::uint64_t seed = {};
+  std::uint32_t bucketCount = {};
+  std::uint32_t slotCount = {};
+};
+
+/**
+ * Minimal perfect hash over a fixed set of distinct 64-bit key hashes,
+ * built with hash-and-displace. Keys outside of the set map to an
+ * arbitrary slot, so callers must verify the key stored at that slot.
+ */
+class PerfectHash {
+  PerfectHashParams params_ = {};
+  std::span<const std::uint32_t> pilots_ = {};
+
+ public:
+  PerfectHash() = default;
+  PerfectHash(PerfectHashParams params, std::span<const std::uint32_t> pilots);
+
+  std::size_t size() const noexcept;
+
+  // Returns the slot of a key hash, in [0, size()).
+  std::size_t operator()(std::uint64_t keyHash) const noexcept;
+
+  // Finds a pilot for every bucket so that the key hashes map to distinct slots.
+  // The returned pilots must outlive any PerfectHash viewing them.
+  static std::pair<PerfectHashParams, std::vector<std::uint32_t>> build(
+      std::span<const std::uint64_t> keyHashes
+  );
+};
+
+}  // namespace wsr::detail
@@ -10,9 +10,62 @@
 
 namespace wsr {
 
+// A binary 32x32 glyph, one bit per pixel, row by row.
+using PackedGlyph = std::array<std::uint64_t, 16>;
+
+// Pixel sums of every 8x8 cell of a grayscale 32x32 glyph, row by row.
+using GlyphBlocks = std::array<std::uint16_t, 16>;
+
+// Lookups of the glyph cache since the reader was created.
+struct GlyphCacheStats {
+    std::uint64_t hits = {};
+    std::uint64_t misses = {};
+};
+
 class Reader {
     static constexpr std::size_t templateSideLength_ = 32;
-    std::vector<cv::Mat> templates_ = {};
+    static_assert(templateSideLength_ * templateSideLength_ == PackedGlyph().size() * 64);
+
+    // A grayscale glyph, aligned so it spans whole cache lines.
+    struct alignas(64) GrayGlyph {
+        std::array<std::uint8_t, templateSideLength_ * templateSideLength_> pixels;
+    };
+
+    // Templates binarized at load, in alphabetical order.
+    std::vector<PackedGlyph> templates_ = {};
+
+    // Grayscale templates in alphabetical order, followed by their inverses.
+    std::vector<GrayGlyph> atlas_ = {};
+
+    // Cell sums of every atlas glyph, in the same order.
+    std::vector<GlyphBlocks> atlasBlocks_ = {};
+    bool cascade_ = true;
+
+    // Results of recently matched binary glyphs, in sets of a few entries
+    // picked by the hash of the glyph. A full set replaces one of its entries,
+    // also picked by the hash.
+    struct GlyphCacheEntry {
+        PackedGlyph glyph = {};
+        float confidence = {};
+        char letter = {};  // Zero while the entry is empty.
+    };
+    static constexpr std::size_t glyphCacheSize_ = 512;
+    static constexpr std::size_t glyphCacheWays_ = 4;
+    mutable std::shared_mutex glyphCacheMutex_ = {};
+    mutable std::vector<GlyphCacheEntry> glyphCache_ = {};
+    mutable std::atomic<std::uint64_t> glyphCacheHits_ = 0;
+    mutable std::atomic<std::uint64_t> glyphCacheMisses_ = 0;
+
+    // Scores a thresholded glyph of the template size against every template,
+    // or returns the cached score of the same glyph.
+    std::pair<float, char> matchGlyph_(const cv::Mat& binary) const;
+
+    // Scores a grayscale glyph by its distance to every atlas glyph.
+    std::pair<float, char> matchExhaustive_(const GrayGlyph& glyph) const;
+
+    // Same as matchExhaustive_, but compares the cell sums first and only
+    // computes full distances for letters whose bound could still win.
+    std::pair<float, char> matchCascade_(const GrayGlyph& glyph) const;
   public:
     Reader();
 
@@ -22,6 +75,38 @@ class Reader {
      */
     std::pair<float, char> match(const cv::Mat& image, cv::Rect bbox) const;
 
+    /**
+     * Same as match, for every bounding box in order. Results replace the
+     * contents of matches. The image is converted to grayscale once, and each
+     * thread reuses its own glyph buffers, so once they have grown matching
+     * does not allocate.
+     */
+    void matchMany(
+        const cv::Mat& image,
+        std::span<const cv::Rect> bboxes,
+        std::vector<std::pair<float, char>>& matches
+    ) const;
+
+    /**
+     * Same as match, but compares the grayscale pixels without thresholding,
+     * which keeps the anti-aliased edges of small or blurred letters.
+     */
+    std::pair<float, char> matchGrayscale(const cv::Mat& image, cv::Rect bbox) const;
+
+    /**
+     * Sets whether grayscale matching prunes letters through the cell sums
+     * before comparing full glyphs. Both give the same results; turning it off
+     * compares every template, as a reference.
+     */
+    void setCascade(bool enabled) noexcept;
+
+    /**
+     * Returns how many binary glyphs were found in the cache. The same
+     * letters are read again on every frame, so nearly every lookup should
+     * hit once the board is on screen.
+     */
+    GlyphCacheStats glyphCacheStats() const noexcept;
+
 };
 
 }  // namespace wsr
\ No newline at end of file
@@ -0,0 +1,142 @@
+/**
+ * service.hpp
+ *
+ * Declaration for the SolverService and SolverClient classes.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+#include "core/solver.hpp"
+#include "core/swipe.hpp"
+#include "core/types.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace wsr::detail {
+
+/*
+ * Every message is a little-endian 16-bit payload size followed by the payload.
+ * A request holds the grid width, height and letter count as one byte each, then
+ * the grid cells row by row and the wheel letters. A response holds a status and
+ * an answer count as one byte each, then every answer as its length followed by
+ * the index of each of its letters on the wheel.
+ */
+inline constexpr std::size_t messageSizeBytes = 2;
+inline constexpr std::size_t maxMessageSize = UINT16_MAX;
+inline constexpr std::size_t maxResponseAnswers = UINT8_MAX;
+
+enum class ServiceStatus : std::uint8_t {
+  STATUS_OK,
+  STATUS_BAD_REQUEST,  // The payload does not describe a level, or its answers do not fit a response.
+};
+
+struct SolveResponse {
+  ServiceStatus status = ServiceStatus::STATUS_OK;
+  std::vector<WheelPath> paths = {};
+};
+
+// Appends a framed message to the buffer.
+void encodeRequest(const Matrix<char> &grid, std::string_view letters, std::vector<std::byte> &message);
+void encodeResponse(const SolveResponse &response, std::vector<std::byte> &message);
+
+// Decodes a payload without its size prefix. Returns std::nullopt if it is malformed,
+// or if a request holds cells other than 0, 1 or A-Z, or letters other than A-Z.
+std::optional<std::pair<Matrix<char>, std::string>> decodeRequest(std::span<const std::byte> payload);
+std::optional<SolveResponse> decodeResponse(std::span<const std::byte> payload);
+
+// Keeps Winsock initialized while alive.
+class Winsock {
+ public:
+  Winsock();
+  Winsock(const Winsock &) = delete;
+  Winsock &operator=(const Winsock &) = delete;
+  ~Winsock();
+};
+
+// Owns a socket handle, closing it once destroyed.
+class Socket {
+  SOCKET handle_ = INVALID_SOCKET;
+
+ public:
+  Socket() = default;
+  explicit Socket(SOCKET handle) noexcept;
+  Socket(const Socket &) = delete;
+  Socket(Socket &&other) noexcept;
+  Socket &operator=(const Socket &) = delete;
+  Socket &operator=(Socket &&other) noexcept;
+  ~Socket();
+
+  SOCKET get() const noexcept;
+
+  // Reads one framed message into the buffer, which holds its payload afterwards.
+  // Returns false once the peer closed the connection or sent a malformed frame.
+  bool receive(std::vector<std::byte> &payload) const;
+
+  // Writes every byte of the buffer. Returns false once the connection is broken.
+  bool send(std::span<const std::byte> bytes) const;
+};
+
+}  // namespace wsr::detail
+
+namespace wsr {
+
+/**
+ * Long-running solver that loads the database once and answers solve requests
+ * from local clients over a Unix domain socket. Each connected client is served
+ * on the pool until it disconnects, so the thread count bounds the clients
+ * served at once.
+ */
+class SolverService {
+  detail::Winsock winsock_ = {};
+  Solver solver_ = {};
+  std::filesystem::path socketPath_ = {};
+  detail::Socket listener_ = {};
+  std::atomic<bool> stopping_ = false;
+
+  std::mutex clientsMutex_ = {};
+  std::vector<SOCKET> clients_ = {};
+
+  // Declared last so connections are drained before the solver goes away.
+  utils::ThreadPool pool_;
+
+  // Answers the requests of one client until it disconnects.
+  void serve_(detail::Socket client);
+
+ public:
+  static constexpr std::string_view defaultSocketName = "wordscraper.sock";
+
+  // Binds the socket, replacing a stale socket file left at the path.
+  // A thread count of zero uses every hardware thread.
+  explicit SolverService(const std::filesystem::path &socketPath, std::size_t threadCount = 0);
+  SolverService(const SolverService &) = delete;
+  SolverService &operator=(const SolverService &) = delete;
+  ~SolverService();
+
+  // Default socket path, inside the temporary directory.
+  static std::filesystem::path defaultSocketPath();
+
+  // Accepts clients until stop is called.
+  void run();
+
+  // Stops accepting clients and disconnects the connected ones.
+  void stop();
+};
+
+/**
+ * Connection to a SolverService. This is not a thread-safe class, so
+ * concurrent callers should each open their own connection.
+ */
+class SolverClient {
+  detail::Winsock winsock_ = {};
+  detail::Socket socket_ = {};
+  std::vector<std::byte> buffer_ = {};
+
+ public:
+  explicit SolverClient(const std::filesystem::path &socketPath = SolverService::defaultSocketPath());
+
+  // Solves a level on the service, returning every unsolved answer as the
+  // positions to drag through on the wheel given by the letters.
+  std::vector<detail::WheelPath> solve(const Matrix<char> &grid, std::string_view letters);
+};
+
+}  // namespace wsr
@@ -0,0 +1,153 @@
+/**
+ * snapshot.hpp
+ *
+ * Declaration for the binary database snapshot format.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace wsr::detail {
+
+/**
+ * Sections stored inside a snapshot. Every section is a tightly
+ * packed array of trivially copyable records, aligned to sectionAlignment.
+ */
+enum class SnapshotSection : std::uint32_t {
+  SECTION_LEVELS,            // LevelRecord[]
+  SECTION_LEVEL_WORDS,       // PoolRef[] into SECTION_LEVEL_TEXT.
+  SECTION_LEVEL_TEXT,        // char[], layouts and answers.
+  SECTION_LEVEL_SIGNATURES,  // Signature[] of each level's letters.
+  SECTION_LAYOUT_PARAMS,     // PerfectHashParams[1] of the layout index.
+  SECTION_LAYOUT_PILOTS,     // std::uint32_t[] perfect hash pilots.
+  SECTION_LAYOUT_GROUPS,     // LayoutGroup[], indexed by perfect hash slot.
+  SECTION_LAYOUT_MEMBERS,    // std::uint32_t[] level indices of each group.
+  SECTION_LAYOUT_SLOTS,      // Slot[] of each group.
+  SECTION_SLOT_CROSSINGS,    // std::uint32_t[] first crossing of each slot, plus an end.
+  SECTION_LAYOUT_CROSSINGS,  // Crossing[] of each slot.
+  SECTION_DIMENSIONS,        // DimensionBucket[], sorted by width then height.
+  SECTION_OCCUPANCY,         // LayoutBits[] of each level, ordered by dimension bucket.
+  SECTION_OCCUPANCY_LEVELS,  // std::uint32_t[] level indices, parallel to SECTION_OCCUPANCY.
+  SECTION_WORDS,             // WordRecord[], sorted by length then descending frequency.
+  SECTION_WORD_LENGTHS,      // std::uint32_t[] first word id of each word length.
+  SECTION_WORD_TEXT,         // char[], dictionary words without frequency text.
+  SECTION_MASK_BUCKETS,      // MaskBucket[], sorted by word length then letter mask.
+  SECTION_MASK_LENGTHS,      // std::uint32_t[] first mask bucket of each word length.
+  SECTION_MASK_WORDS,        // std::uint32_t[] word ids of each mask bucket.
+  SECTION_LETTER_COUNTS,     // LetterCounts[], parallel to SECTION_WORDS.
+  SECTION_DAWG_NODES,        // DawgNode[] of the dictionary word graph, root first.
+  SECTION_DAWG_EDGES,        // DawgEdge[] of the dictionary word graph.
+  SECTION_DAWG_WORDS,        // std::uint32_t[] word id of each word graph rank.
+  SECTION_COUNT
+};
+
+struct SnapshotRange {
+  std::uint64_t offset = {};
+  std::uint64_t size = {};
+};
+
+// Identifies the version of a text source a snapshot was compiled from.
+struct SnapshotStamp {
+  std::uint64_t size = {};
+  std::int64_t time = {};
+
+  bool operator==(const SnapshotStamp &rhs) const noexcept = default;
+};
+
+struct SnapshotHeader {
+  static constexpr std::uint32_t expectedMagic = 0x53525357U;  // "WSRS"
+  static constexpr std::uint32_t expectedVersion = 9U;
+
+  std::uint32_t magic = {};
+  std::uint32_t version = {};
+  SnapshotStamp levelSource = {};
+  SnapshotStamp dictionarySource = {};
+  std::array<SnapshotRange, std::size_t(SnapshotSection::SECTION_COUNT)> sections = {};
+};
+
+/**
+ * Read-only memory mapping of an entire file.
+ */
+class MappedFile {
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+  const std::byte *data_ = nullptr;
+  std::size_t size_ = {};
+
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::filesystem::path &path);
+  MappedFile(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  ~MappedFile();
+
+  std::span<const std::byte> bytes() const noexcept;
+};
+
+/**
+ * A validated snapshot image, either mapped from disk or owned in memory.
+ * Sections are used in place and never copied.
+ */
+class Snapshot {
+  MappedFile mapping_ = {};
+  std::vector<std::byte> buffer_ = {};
+  std::span<const std::byte> bytes_ = {};
+  SnapshotHeader header_ = {};
+
+  void validate_();
+
+ public:
+  Snapshot() = default;
+  explicit Snapshot(MappedFile mapping);
+  explicit Snapshot(std::vector<std::byte> buffer);
+
+  const SnapshotHeader &header() const noexcept;
+
+  // Total size of the image in bytes.
+  std::size_t size() const noexcept;
+
+  template <typename T>
+  std::span<const T> section(SnapshotSection section) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    WSR_EXCEPTMSG(sectionErrMsg) = "Snapshot section does not match its record type.";
+    const SnapshotRange range = header_.sections[std::size_t(section)];
+    if (range.size == 0) {
+      return {};
+    }
+    const std::byte *begin = bytes_.data() + range.offset;
+    const bool aligned = reinterpret_cast<std::uintptr_t>(begin) % alignof(T) == 0;
+    utils::runtimeRequire(aligned && range.size % sizeof(T) == 0, WSR_EXCEPTION(sectionErrMsg));
+    return {reinterpret_cast<const T *>(begin), std::size_t(range.size / sizeof(T))};
+  }
+};
+
+/**
+ * Assembles sections into a snapshot image.
+ */
+class SnapshotBuilder {
+  static constexpr std::size_t sectionAlignment = 64;
+  std::array<std::vector<std::byte>, std::size_t(SnapshotSection::SECTION_COUNT)> sections_ = {};
+
+ public:
+  template <typename T>
+  void setSection(SnapshotSection section, std::span<const T> data) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto bytes = std::as_bytes(data);
+    sections_[std::size_t(section)].assign(bytes.begin(), bytes.end());
+  }
+
+  // Lays out the header and every section into a single image.
+  std::vector<std::byte> build(SnapshotStamp levelSource, SnapshotStamp dictionarySource) const;
+};
+
+// Returns the stamp of a source file on disk.
+SnapshotStamp stampFile(const std::filesystem::path &path);
+
+// Writes a snapshot image to disk, replacing any existing file.
+void writeSnapshot(const std::filesystem::path &path, std::span<const std::byte> image);
+
+}  // namespace wsr::detail
@@ -6,11 +6,20 @@
 
 #pragma once
 
+#include "core/crossword.hpp"
+#include "core/dawg.hpp"
+#include "core/layout.hpp"
 #include "core/pch.hpp"
+#include "core/perfect_hash.hpp"
+#include "core/snapshot.hpp"
 #include "core/types.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace wsr::detail {
 
+// Letter counts of a Signature, padded with zeros to one 256-bit lane.
+using LetterCounts = std::array<std::uint8_t, 32>;
+
 class Signature {
   static constexpr std::size_t alphaCount = 26ULL;
   std::uint32_t partial_ = {};
@@ -19,6 +28,7 @@ class Signature {
  public:
   Signature() = default;
   Signature(std::string_view string);
+  explicit Signature(const LetterCounts &counts) noexcept;
 
   bool operator==(const Signature &rhs) const noexcept;
   bool operator!=(const Signature &rhs) const noexcept;
@@ -36,6 +46,11 @@ class Signature {
   // Operates on the lexicographic ordering of the sorted
   // input strings during Signature construction.
   bool operator<(const Signature &rhs) const noexcept;
+
+  // Distinct letters as a bitmask, with bit 0 for 'A'.
+  std::uint32_t mask() const noexcept;
+
+  LetterCounts counts() const noexcept;
 };
 
 enum class QueryType : std::uint8_t {
@@ -45,45 +60,424 @@ enum class QueryType : std::uint8_t {
   QUERY_INEQUALITY
 };
 
+/**
+ * Writes whether every candidate matches the letters under a query type,
+ * as the letters would compare against it. Uses AVX2 when the processor supports it.
+ */
+void matchSignatures(
+    const LetterCounts &letters,
+    std::span<const LetterCounts> candidates,
+    QueryType type,
+    std::span<std::uint8_t> out
+) noexcept;
+
+enum class QueryStrategy : std::uint8_t {
+  STRATEGY_AUTO,   // Uses the letter mask index whenever it supports the query.
+  STRATEGY_LINEAR  // Scans the letter counts of every dictionary entry.
+};
+
 struct LevelData {
   Matrix<char> layout = {};
   std::vector<std::string_view> words = {};
+
+  // Words whose cells are not all revealed on the queried grid, in the order of words.
+  std::vector<std::string_view> unsolved = {};
 };
 
 struct DictionaryEntry {
   Signature signature = {};
   std::string_view view = {};
+  // Dequantized from the snapshot, so it is within 0.1% of the dictionary's
+  // frequency, and nearby frequencies may come back equal.
   std::size_t frequency = {};
 };
 
+// Location of a string inside one of the snapshot text sections.
+struct PoolRef {
+  std::uint32_t offset = {};
+  std::uint32_t size = {};
+};
+
+struct LevelRecord {
+  PoolRef layout = {};
+  std::uint32_t wordsBegin = {};  // Index into the level word table.
+  std::uint16_t wordCount = {};
+  std::uint8_t width = {};
+  std::uint8_t height = {};
+};
+
+// Levels sharing an exact layout, stored at the layout's perfect hash slot.
+struct LayoutGroup {
+  LayoutKey key = {};
+  std::uint32_t levelsBegin = {};  // Index into the layout member table.
+  std::uint32_t levelCount = {};
+  std::uint32_t slotsBegin = {};  // Index into the layout slot table.
+  std::uint32_t slotCount = {};
+};
+
+// Levels sharing grid dimensions, scanned by nearest-layout lookups.
+struct DimensionBucket {
+  std::uint8_t width = {};
+  std::uint8_t height = {};
+  std::uint32_t begin = {};  // Index into the occupancy tables.
+  std::uint32_t count = {};
+};
+
+// Compact dictionary record. Letter counts are stored in a separate table.
+struct WordRecord {
+  std::uint32_t offset = {};  // Into the word text.
+  std::uint8_t length = {};
+  std::uint8_t padding = {};
+  std::uint16_t frequency = {};  // Quantized on a logarithmic scale, see quantizeFrequency.
+
+  // Maps a frequency to 1/1024ths of a doubling. The mapping is monotone, so it
+  // never inverts two frequencies, but ones within 1/1024th of a doubling of
+  // each other can map to the same level.
+  static std::uint16_t quantizeFrequency(std::uint64_t frequency) noexcept;
+
+  // Returns the frequency within 0.1% of the one quantized.
+  static std::uint64_t dequantizeFrequency(std::uint16_t level) noexcept;
+};
+
+// Dictionary words sharing a length and a set of distinct letters.
+struct MaskBucket {
+  std::uint32_t mask = {};
+  std::uint32_t begin = {};  // Index into the mask word table.
+  std::uint32_t count = {};
+};
+
+/**
+ * Non-owning view of a stored level, valid for the lifetime of its Database.
+ */
+struct LevelView {
+  std::uint32_t level = {};
+  std::uint8_t width = {};
+  std::uint8_t height = {};
+  std::string_view layout = {};  // Row-major '0' and '1' cells.
+  std::span<const PoolRef> words = {};
+  std::string_view text = {};  // Text the word references point into.
+
+  std::string_view word(std::size_t i) const noexcept {
+    WSR_ASSERT(i < words.size());
+    return text.substr(words[i].offset, words[i].size);
+  }
+};
+
+/**
+ * Single-pass range over the ids of the dictionary entries matching a query,
+ * in dictionary order. Entries are matched a batch at a time into an internal
+ * buffer, so iterating never allocates. Iterators refer to the range itself.
+ */
+class DictionaryMatches {
+  static constexpr std::size_t batchSize = 256;
+  std::span<const LetterCounts> candidates_ = {};
+  LetterCounts letters_ = {};
+  QueryType type_ = {};
+  std::size_t batchBegin_ = {};
+  std::size_t position_ = {};  // Index inside the current batch.
+  std::array<std::uint8_t, batchSize> matches_ = {};
+
+  void matchBatch_() noexcept;
+
+  // Advances to the next match at or after the current position.
+  void seek_() noexcept;
+
+ public:
+  class Iterator {
+    DictionaryMatches *range_ = nullptr;
+
+   public:
+    using value_type = std::uint32_t;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    explicit Iterator(DictionaryMatches *range) noexcept : range_(range) {}
+
+    std::uint32_t operator*() const noexcept {
+      return std::uint32_t(range_->batchBegin_ + range_->position_);
+    }
+
+    Iterator &operator++() noexcept {
+      ++range_->position_;
+      range_->seek_();
+      return *this;
+    }
+
+    void operator++(int) noexcept {
+      ++*this;
+    }
+
+    bool operator==(std::default_sentinel_t) const noexcept {
+      return range_->batchBegin_ >= range_->candidates_.size();
+    }
+  };
+
+  DictionaryMatches(
+      std::span<const LetterCounts> candidates, const LetterCounts &letters, QueryType type
+  ) noexcept;
+
+  Iterator begin() noexcept {
+    return Iterator(this);
+  }
+
+  std::default_sentinel_t end() const noexcept {
+    return {};
+  }
+};
+
+/**
+ * Level and dictionary database. All records live inside a snapshot image
+ * that is either memory-mapped from disk or compiled from the text sources.
+ */
 class Database {
-  std::string dictionaryData_ = {};
-  std::string levelData_ = {};
-  std::vector<DictionaryEntry> dictionaryEntries_ = {};
+  Snapshot snapshot_ = {};
+  std::span<const LevelRecord> levels_ = {};
+  std::span<const PoolRef> levelWords_ = {};
+  std::span<const Signature> levelSignatures_ = {};
+  std::string_view levelText_ = {};
+  PerfectHash layoutHash_ = {};
+  std::span<const LayoutGroup> layoutGroups_ = {};
+  std::span<const std::uint32_t> layoutMembers_ = {};
+  std::span<const Slot> layoutSlots_ = {};
+  std::span<const std::uint32_t> slotCrossings_ = {};
+  std::span<const Crossing> layoutCrossings_ = {};
+  std::span<const DimensionBucket> dimensions_ = {};
+  std::span<const LayoutBits> occupancy_ = {};
+  std::span<const std::uint32_t> occupancyLevels_ = {};
+  std::span<const WordRecord> words_ = {};
+  std::span<const std::uint32_t> wordLengths_ = {};
+  std::span<const LetterCounts> letterCounts_ = {};
+  std::string_view wordText_ = {};
+  std::span<const MaskBucket> maskBuckets_ = {};
+  std::span<const std::uint32_t> maskLengths_ = {};
+  std::span<const std::uint32_t> maskWords_ = {};
+  Dawg dawg_ = {};
+  std::span<const std::uint32_t> dawgWords_ = {};
 
-  // Index is the map layout.
-  std::unordered_map<std::size_t, LevelData> levelEntriesMap_ = {};
+  // Analyses of layouts missing from the snapshot, computed on first use. Holds at most
+  // layoutMemoCapacity of them, evicting one to make room for another.
+  static constexpr std::size_t layoutMemoCapacity = 4096;
+  mutable std::mutex layoutMemoMutex_ = {};
+  mutable std::unordered_map<LayoutKey, std::shared_ptr<const LayoutStructure>, LayoutKeyHash>
+      layoutMemo_ = {};
 
-  void sortFields_();
-  void parseDictionaryData_();
-  void parseLevelData_();
+  void bindSnapshot_();
+  LevelView levelView_(std::size_t level) const noexcept;
+  LevelData levelData_(std::size_t level) const;
+
+  // Levels stored with the grid's exact layout, or an empty span.
+  std::span<const std::uint32_t> exactLayoutLevels_(const Matrix<char> &grid) const noexcept;
+
+  // Places the level's answers in the slots around the grid's revealed letters without
+  // copying the level. Returns the word index of each slot, valid until the thread's
+  // next placement, or an empty span if the revealed letters contradict every placement.
+  std::span<const std::size_t> placeLevel_(
+      std::size_t level, std::span<const Slot> slots, const Matrix<char> &grid
+  ) const;
+
+  // Places the level's answers on the grid around its revealed letters.
+  // Returns std::nullopt if the revealed letters contradict every placement.
+  std::optional<LevelData> resolveLevel_(std::size_t level, const Matrix<char> &grid) const;
+  std::string_view word_(std::size_t id) const noexcept;
+
+  // Appends the word ids matching a subset or equality query, visiting only the
+  // mask buckets that can hold them. Returns false if the index cannot serve the query.
+  bool queryIndexed_(
+      const Signature &letterSig,
+      std::size_t letterCount,
+      QueryType type,
+      std::vector<std::uint32_t> &ids
+  ) const;
 
  public:
+  static constexpr std::string_view snapshotFileName = "data.snapshot";
+
   Database();
+  explicit Database(const std::filesystem::path &dataDirectory);
+
+  // Parses data.txt and words.txt inside a data directory into a snapshot image.
+  // A thread count of zero parses on every hardware thread.
+  static std::vector<std::byte> compile(
+      const std::filesystem::path &dataDirectory, std::size_t threadCount = 0
+  );
 
-  // Query the entries database for a matching answer key.
+  // Query the entries database for a matching answer key. Levels sharing
+  // the grid's exact layout are told apart by their letters, then by any
+  // letters already revealed on the grid, which also decide LevelData::unsolved.
   std::optional<LevelData> query(const Matrix<char> &grid, std::string_view letters) const;
 
+  // Same as the grid query above, but views the stored level instead of copying it,
+  // and leaves finding the unsolved answers to the caller.
+  std::optional<LevelView> queryView(const Matrix<char> &grid, std::string_view letters) const;
+
+  // Query the entries database for the level with the same letters whose layout differs
+  // from the grid in the fewest cells, up to maxDistance. Tolerates misread grid cells.
+  std::optional<LevelData> queryNearest(
+      const Matrix<char> &grid, std::string_view letters, std::size_t maxDistance
+  ) const;
+
   // Query the dictionary for entries that match the criteria given a query type.
-  std::vector<DictionaryEntry> query(std::string_view letters, QueryType type) const;
+  // Entries are returned in dictionary order: by length, then by descending frequency.
+  std::vector<DictionaryEntry> query(
+      std::string_view letters,
+      QueryType type,
+      QueryStrategy strategy = QueryStrategy::STRATEGY_AUTO
+  ) const;
+
+  // Same as the query above, but writes word ids into a caller-provided buffer,
+  // replacing its contents and reusing its capacity.
+  void queryIds(
+      std::string_view letters,
+      QueryType type,
+      std::vector<std::uint32_t> &ids,
+      QueryStrategy strategy = QueryStrategy::STRATEGY_AUTO
+  ) const;
+
+  // Lazily scans the dictionary for the ids of the entries matching a query type.
+  DictionaryMatches matches(std::string_view letters, QueryType type) const;
+
+  // Generate the dictionary entries that can be spelled from the letters and pass
+  // the filter by walking the dictionary word graph. Entries are returned by
+  // descending frequency.
+  std::vector<DictionaryEntry> generate(std::string_view letters, const WordFilter &filter = {}) const;
+
+  // Same as generate above, but writes word ids into a caller-provided buffer,
+  // replacing its contents and reusing its capacity.
+  void generateIds(
+      std::string_view letters, const WordFilter &filter, std::vector<std::uint32_t> &ids
+  ) const;
+
+  // Query the dictionary for the k most frequent entries of every word length that
+  // match the criteria given a query type and pass the filter. Each length's scan
+  // stops after its k-th match. Entries are returned by length, then by descending frequency.
+  std::vector<DictionaryEntry> queryTop(
+      std::string_view letters, QueryType type, std::size_t k, const WordFilter &filter = {}
+  ) const;
+
+  // Same as queryTop above, but writes word ids into a caller-provided buffer,
+  // replacing its contents and reusing its capacity.
+  void queryTopIds(
+      std::string_view letters,
+      QueryType type,
+      std::size_t k,
+      const WordFilter &filter,
+      std::vector<std::uint32_t> &ids
+  ) const;
+
+  // Returns the slots and crossings of a layout. Stored layouts are viewed in the
+  // snapshot, while others are analyzed and memoized, up to layoutMemoCapacity
+  // layouts. The returned analysis keeps its views alive after they are evicted.
+  // Safe to call from multiple threads.
+  LayoutAnalysis layoutAnalysis(const LayoutKey &key) const;
+
+  // Returns the dictionary entry of a word id.
+  DictionaryEntry entry(std::size_t id) const noexcept;
 };
 
 }  // namespace wsr::detail
 
 namespace wsr {
 
+// An answer with how sure the solver is of it.
+struct RankedAnswer {
+  std::string_view word = {};
+  detail::Slot slot = {};          // Zero length when the answer came from the database.
+  std::size_t candidates = {};     // Words left fitting the slot, one when the answer is forced.
+  std::size_t frequencyRank = {};  // Candidates of the slot more frequent than the answer.
+  double confidence = {};          // Between zero and one.
+};
+
+struct PartialSolution {
+  std::vector<RankedAnswer> answers = {};  // By descending confidence.
+  bool complete = {};                      // Whether every unsolved slot has an answer.
+};
+
+// How a session picks the next word to try on an unknown level.
+enum class GuessPolicy : std::uint8_t {
+  POLICY_SUREST_FILL,    // The surest answer of the current fill.
+  POLICY_EXPECTED_COST,  // The word likeliest to be an answer, favoring ones that narrow crossings.
+                         // Fewer swipes, but each move costs several re-solves.
+};
+
+/**
+ * Solving state of one level across moves. Accepted words and revealed letters
+ * narrow only the slots they touch, and the current fill is kept until a move
+ * contradicts it. Views the database it was started from, which must outlive it.
+ */
+class SolveSession {
+  friend class Solver;
+
+  Matrix<char> grid_ = {};
+  std::vector<std::string_view> stored_ = {};  // Answers of a level found in the database.
+  std::optional<detail::Crossword> crossword_ = {};
+  std::vector<bool> solved_ = {};  // Per slot.
+  std::vector<std::string_view> accepted_ = {};
+  std::optional<detail::CrosswordFill> fill_ = {};
+  GuessPolicy policy_ = GuessPolicy::POLICY_SUREST_FILL;
+
+  // Candidate beliefs of the expected-cost policy, kept until a move changes the board.
+  struct GuessBeliefs {
+    static constexpr std::size_t alphaCount = 26;
+    std::vector<std::vector<detail::RankedCandidate>> candidates = {};  // Per slot.
+    std::vector<std::vector<double>> probabilities = {};                // Per candidate.
+    std::vector<std::size_t> massBegin = {};                            // Per slot, into letterMass.
+    std::vector<double> letterMass = {};  // Chance of each letter at each position of each slot.
+
+    // Chance of the crossing slot showing the word's letter at the crossing.
+    double crossingMass(const detail::Crossing &crossing, std::string_view word) const noexcept;
+  };
+  std::optional<GuessBeliefs> beliefs_ = {};
+
+  // Shuffled fills of the expected-cost policy. A move only redraws the ones it contradicts.
+  std::vector<detail::CrosswordFill> samples_ = {};
+  std::uint64_t nextSampleSeed_ = 1;
+
+  SolveSession() = default;
+  bool isAccepted_(std::string_view word) const noexcept;
+
+  // Whether every word of the fill is still a candidate of its slot.
+  bool fillHolds_(const detail::CrosswordFill &fill) const;
+
+  void updateBeliefs_();
+  void updateSamples_();
+
+  // Ranks every candidate word by its chance of being an answer in any unsolved
+  // slot, plus the share of crossing candidates an accepted guess would rule out.
+  std::optional<RankedAnswer> expectedCostWord_();
+
+  // Drops the cached beliefs, and the current and sampled fills a move contradicts.
+  void checkFill_();
+
+ public:
+  // Starts a session that solves the grid from the dictionary alone.
+  SolveSession(
+      const detail::Database &database, const Matrix<char> &grid, std::string_view letters
+  );
+
+  // Records a word the game accepted.
+  void wordAccepted(std::string_view word);
+
+  // Records a word the game rejected.
+  void wordRejected(std::string_view word);
+
+  // Records a letter the game revealed on the grid.
+  void cellRevealed(Point cell, char letter);
+
+  // Sets how unknown levels pick their next word.
+  void setGuessPolicy(GuessPolicy policy) noexcept;
+
+  // Returns the next word to try under the guess policy, or std::nullopt once none
+  // is left or known.
+  std::optional<RankedAnswer> nextWord();
+};
+
 class Solver {
   detail::Database database_ = {};
+  std::size_t layoutTolerance_ = 1;
+  bool databaseLookup_ = true;
+
+  // Runs portfolio searches over unknown layouts, or null to search on the calling thread.
+  std::unique_ptr<utils::ThreadPool> searchPool_ = {};
 
   // Manually solves the grid with the letters based on
   // the current known vocabulary via constraint propagation.
@@ -91,16 +485,44 @@ class Solver {
       const Matrix<char> &grid, std::string_view letters
   ) const;
 
-  // Solves a level if grid structure is found in the
-  // database. Returns an empty vector upon failure.
-  std::vector<std::string_view> querySolve_(
+  // Searches the grid until the deadline, keeping the deepest partial fill.
+  PartialSolution anytimeSolve_(
+      const Matrix<char> &grid, std::string_view letters, std::chrono::steady_clock::time_point deadline
+  ) const;
+
+  // Solves a level if grid structure is found in the database. Returns
+  // the unsolved answers, or std::nullopt upon failure.
+  std::optional<std::vector<std::string_view>> querySolve_(
       const Matrix<char> &grid, std::string_view letters
   ) const;
 
  public:
+  static constexpr std::size_t maxLayoutTolerance = 3;
+
+  // Sets how many misread grid cells a database lookup tolerates,
+  // up to maxLayoutTolerance. Zero requires an exact layout.
+  void setLayoutTolerance(std::size_t cells);
+
+  // Sets whether levels are looked up in the database before searching. Turning
+  // it off sends every level through the dictionary fallback.
+  void setDatabaseLookup(bool enabled) noexcept;
+
+  // Sets how many threads search unknown layouts the database cannot solve.
+  // One searches on the calling thread, and zero uses every hardware thread.
+  void setSearchThreads(std::size_t threadCount);
 
   // Solves a given level and returns the answers. Returns an empty vector upon failure.
-  std::vector<std::string_view> solve(const Matrix<char> &grid, std::string_view letters);
+  std::vector<std::string_view> solve(const Matrix<char> &grid, std::string_view letters) const;
+
+  // Starts a session solving a level move by move, looking the level up in the
+  // database first. The solver must outlive the session.
+  SolveSession startSession(const Matrix<char> &grid, std::string_view letters) const;
+
+  // Solves a given level, returning the answers found by the deadline along with how
+  // sure each one is, so the surest words can be entered while the rest are unknown.
+  PartialSolution solve(
+      const Matrix<char> &grid, std::string_view letters, std::chrono::steady_clock::time_point deadline
+  ) const;
 };
 
 }  // namespace wsr
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+ * swipe.hpp
+ *
+ * Declaration for the SwipePlan class.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+#include "core/types.hpp"
+
+namespace wsr::detail {
+
+// Indices into the wheel letters, one per letter of an answer.
+using WheelPath = std::vector<std::uint8_t>;
+
+// Largest wheel whose repeated letters are placed by the shortest drag.
+inline constexpr std::size_t maxPlannedWheelSize = 16;
+
+// Maps every letter of the word, ignoring case, to the first wheel position not
+// used before in the word. Returns std::nullopt if the wheel cannot spell the word.
+std::optional<WheelPath> wheelPath(std::string_view word, std::string_view letters);
+
+// Same as wheelPath above, but picks among repeated letters the positions that
+// make the shortest drag through the given position of every wheel letter.
+std::optional<WheelPath> shortestWheelPath(
+    std::string_view word, std::string_view letters, std::span<const cv::Point> positions
+);
+
+}  // namespace wsr::detail
+
+namespace wsr {
+
+// An answer with the wheel positions and screen points to drag through.
+struct SwipePath {
+  std::string_view word = {};
+  detail::WheelPath wheel = {};
+  std::vector<cv::Point> waypoints = {};
+};
+
+/**
+ * Drags for the answers of one level, compiled once from its letter wheel so
+ * entering an answer needs no letter lookups. Waypoints are the centers of the
+ * wheel letters, in the coordinates of the screen the level was found on.
+ * Views the answers, which must outlive the plan.
+ */
+class SwipePlan {
+  std::vector<SwipePath> paths_ = {};
+
+ public:
+  SwipePlan() = default;
+
+  // Answers the wheel cannot spell are left out.
+  SwipePlan(const Level &level, std::span<const std::string_view> answers);
+
+  // Paths in the order of the answers.
+  std::span<const SwipePath> paths() const noexcept;
+
+  // Returns the path of an answer, ignoring case, or nullptr if it has none.
+  const SwipePath *find(std::string_view word) const noexcept;
+};
+
+}  // namespace wsr
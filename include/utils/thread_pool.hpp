@@ -0,0 +1,83 @@
+/**
+ * thread_pool.hpp
+ *
+ * Declaration and implementation for the ThreadPool class.
+ */
+
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace wsr::utils {
+
+/**
+ * Fixed-size pool of worker threads consuming a FIFO task queue.
+ * Pending tasks are drained before the pool is destroyed.
+ */
+class ThreadPool {
+  std::mutex mutex_ = {};
+  std::condition_variable available_ = {};
+  std::deque<std::function<void()>> tasks_ = {};
+  std::vector<std::thread> workers_ = {};
+  bool stopping_ = false;
+
+  void work_() {
+    while (true) {
+      std::function<void()> task = {};
+      {
+        std::unique_lock lock(mutex_);
+        available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+ public:
+  // A thread count of zero uses every hardware thread.
+  explicit ThreadPool(std::size_t threadCount = 0) {
+    if (threadCount == 0) {
+      threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+      workers_.emplace_back([this] { work_(); });
+    }
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+    available_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  std::size_t size() const noexcept {
+    return workers_.size();
+  }
+
+  // Queues a task and returns a future for its result.
+  template <typename F>
+  std::future<std::invoke_result_t<std::decay_t<F>>> submit(F &&function) {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(function));
+    std::future<R> result = task->get_future();
+    {
+      std::lock_guard lock(mutex_);
+      tasks_.emplace_back([task] { (*task)(); });
+    }
+    available_.notify_one();
+    return result;
+  }
+};
+
+}  // namespace wsr::utils
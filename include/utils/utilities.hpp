@@ -24,6 +24,14 @@
   #define WSR_PROFILE_SCOPEN(name)
 #endif
 
+// Allows AVX2 intrinsics inside a function without raising the target of the whole project.
+// cl.exe permits these intrinsics anywhere; clang-cl requires the attribute.
+#if defined(__clang__)
+  #define WSR_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+  #define WSR_TARGET_AVX2
+#endif
+
 #define WSR_IMGSHOW(image)                                                                   \
   do {                                                                                       \
     cv::imshow(                                                                              \
@@ -170,6 +178,27 @@ inline void runtimeRequire(bool condition, std::string_view message) {
   }
 }
 
+/**
+ * Finalizer from SplitMix64. Spreads every input bit across the output.
+ */
+constexpr std::uint64_t hashMix(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * Compares words of ASCII letters regardless of case.
+ */
+inline bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+  return std::ranges::equal(a, b, [](char x, char y) {
+    return (x & ~0x20) == (y & ~0x20);
+  });
+}
+
 /**
  * Uses a busy-wait spin loop with _mm_pause().
  * Can be used when wait-time is smaller than the system's tick rate.
@@ -185,6 +214,34 @@ inline void preciseSleepFor(std::chrono::duration<Rep, Period> duration) {
   }
 }
 
+/**
+ * Checks if both the processor and the operating system support AVX2.
+ * The result is computed once and cached.
+ */
+inline bool cpuSupportsAvx2() {
+  static const bool supported = [] {
+    constexpr int osxsaveBit = 1 << 27;
+    constexpr int avxBit = 1 << 28;
+    constexpr int avx2Bit = 1 << 5;
+    constexpr unsigned long long ymmStateMask = 0x6;
+    std::array<int, 4> info = {};
+    __cpuid(info.data(), 0);
+    if (info[0] < 7) {
+      return false;
+    }
+    __cpuid(info.data(), 1);
+    if (!(info[2] & osxsaveBit) || !(info[2] & avxBit)) {
+      return false;
+    }
+    if ((_xgetbv(0) & ymmStateMask) != ymmStateMask) {  // YMM state saved by the OS.
+      return false;
+    }
+    __cpuidex(info.data(), 7, 0);
+    return (info[1] & avx2Bit) != 0;
+  }();
+  return supported;
+}
+
 /**
  * Checks if a given value is within a specified range.
  * Defaults by considering a value in range if its
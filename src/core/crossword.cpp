@@ -0,0 +1,604 @@
+/**
+ * crossword.cpp
+ *
+ * Implementation for crossword.hpp
+ */
+
+#include "core/crossword.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+constexpr std::size_t alphaCount = 26;
+
+// Returns alphaCount for non-alphabetic characters.
+std::size_t letterIndex(char c) noexcept {
+  const char upper = char(c & ~0x20);
+  return upper >= 'A' && upper <= 'Z' ? std::size_t(upper - 'A') : alphaCount;
+}
+
+std::size_t popcount(std::span<const std::uint64_t> bits) noexcept {
+  std::size_t count = 0;
+  for (const auto block : bits) {
+    count += std::size_t(std::popcount(block));
+  }
+  return count;
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+Crossword::Crossword(
+    const LayoutAnalysis &layout,
+    const Matrix<char> &grid,
+    std::span<const std::string_view> words,
+    std::span<const std::size_t> frequencies
+)
+    : layout_(layout) {
+  WSR_PROFILE_SCOPE();
+  WSR_ASSERT(!layout_.crossingsBegin.empty());
+  WSR_ASSERT(frequencies.empty() || frequencies.size() == words.size());
+
+  // Candidates are grouped by length, keeping their order.
+  std::size_t maxLength = 0;
+  for (const auto &slot : layout_.slots) {
+    maxLength = std::max<std::size_t>(maxLength, slot.length);
+  }
+  std::vector<bool> slotLengths(maxLength + 1);
+  for (const auto &slot : layout_.slots) {
+    slotLengths[slot.length] = true;
+  }
+  lengthWords_.resize(maxLength + 1);
+  lengthFrequencies_.resize(frequencies.empty() ? 0 : maxLength + 1);
+  for (std::size_t i = 0; i < words.size(); ++i) {
+    const std::string_view word = words[i];
+    const bool alphabetic = std::ranges::all_of(word, [](char c) {
+      return letterIndex(c) < alphaCount;
+    });
+    if (word.size() <= maxLength && slotLengths[word.size()] && alphabetic) {
+      lengthWords_[word.size()].push_back(word);
+      if (!frequencies.empty()) {
+        lengthFrequencies_[word.size()].push_back(frequencies[i]);
+      }
+    }
+  }
+  letterBits_.resize(maxLength + 1);
+  for (std::size_t length = 1; length <= maxLength; ++length) {
+    const auto &candidates = lengthWords_[length];
+    const std::size_t blocks = (candidates.size() + 63) / 64;
+    letterBits_[length].resize(length * alphaCount * blocks);
+    for (std::size_t w = 0; w < candidates.size(); ++w) {
+      for (std::size_t i = 0; i < length; ++i) {
+        const std::size_t offset = (i * alphaCount + letterIndex(candidates[w][i])) * blocks;
+        letterBits_[length][offset + w / 64] |= 1ULL << (w % 64);
+      }
+    }
+  }
+
+  // Every slot starts with all candidates of its length, minus those contradicting the grid.
+  domainsBegin_.push_back(0);
+  for (const auto &slot : layout_.slots) {
+    domainsBegin_.push_back(
+        domainsBegin_.back() + std::uint32_t((lengthWords_[slot.length].size() + 63) / 64)
+    );
+  }
+  domains_.resize(domainsBegin_.back());
+  std::vector<std::uint32_t> changed = {};
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    const auto domain = domain_(domains_, s);
+    const std::size_t count = lengthWords_[layout_.slots[s].length].size();
+    for (std::size_t w = 0; w < count; ++w) {
+      domain[w / 64] |= 1ULL << (w % 64);
+    }
+    for (std::size_t i = 0; i < layout_.slots[s].length; ++i) {
+      const char cell = grid[layout_.slots[s].cell(i)];
+      if (!isRevealed(cell)) {
+        continue;
+      }
+      const auto allowed = candidatesWith_(layout_.slots[s].length, i, letterIndex(cell));
+      for (std::size_t k = 0; k < domain.size(); ++k) {
+        domain[k] &= allowed[k];
+      }
+    }
+    changed.push_back(std::uint32_t(s));
+  }
+  consistent_ = std::ranges::all_of(changed, [this](std::uint32_t s) {
+    return popcount(domain_(domains_, s)) > 0;
+  }) && propagate_(domains_, changed);
+}
+
+std::size_t Crossword::blockCount_(std::size_t slot) const noexcept {
+  return domainsBegin_[slot + 1] - domainsBegin_[slot];
+}
+
+std::span<std::uint64_t> Crossword::domain_(Domains &domains, std::size_t slot) const noexcept {
+  return std::span(domains).subspan(domainsBegin_[slot], blockCount_(slot));
+}
+
+std::span<const std::uint64_t> Crossword::candidatesWith_(
+    std::size_t length, std::size_t position, std::size_t letter
+) const noexcept {
+  WSR_ASSERT(letter < alphaCount && position < length);
+  const std::size_t blocks = (lengthWords_[length].size() + 63) / 64;
+  return std::span(letterBits_[length]).subspan((position * alphaCount + letter) * blocks, blocks);
+}
+
+bool Crossword::revise_(Domains &domains, std::size_t slot, const Crossing &crossing) const noexcept {
+  const auto other = domain_(domains, crossing.slot);
+  const std::size_t otherLength = layout_.slots[crossing.slot].length;
+  std::uint32_t support = 0;
+  for (std::size_t letter = 0; letter < alphaCount; ++letter) {
+    const auto bits = candidatesWith_(otherLength, crossing.otherPosition, letter);
+    for (std::size_t k = 0; k < other.size(); ++k) {
+      if (other[k] & bits[k]) {
+        support |= 1U << letter;
+        break;
+      }
+    }
+  }
+
+  const auto domain = domain_(domains, slot);
+  bool changed = false;
+  for (std::size_t k = 0; k < domain.size(); ++k) {
+    std::uint64_t allowed = 0;
+    for (std::uint32_t letters = support; letters != 0; letters &= letters - 1) {
+      const auto letter = std::size_t(std::countr_zero(letters));
+      allowed |= candidatesWith_(layout_.slots[slot].length, crossing.position, letter)[k];
+    }
+    changed |= (domain[k] & ~allowed) != 0;
+    domain[k] &= allowed;
+  }
+  return changed;
+}
+
+bool Crossword::propagate_(Domains &domains, std::span<const std::uint32_t> changed) const {
+  // Arcs are crossing entries, each revising its owner slot against the crossing slot.
+  std::vector<std::uint32_t> queue = {};
+  std::vector<bool> queued(layout_.crossings.size());
+  const auto enqueueInto = [&](std::uint32_t slot) {
+    for (const auto &crossing : layout_.crossingsOf(slot)) {
+      const std::uint32_t arc = crossing.reverse;
+      if (!queued[arc]) {
+        queued[arc] = true;
+        queue.push_back(arc);
+      }
+    }
+  };
+  for (const auto slot : changed) {
+    enqueueInto(slot);
+  }
+  while (!queue.empty()) {
+    const std::uint32_t arc = queue.back();
+    queue.pop_back();
+    queued[arc] = false;
+    const Crossing &crossing = layout_.crossings[arc];
+    const std::uint32_t slot = layout_.crossings[crossing.reverse].slot;
+    if (revise_(domains, slot, crossing)) {
+      if (popcount(domain_(domains, slot)) == 0) {
+        return false;
+      }
+      enqueueInto(slot);
+    }
+  }
+  return true;
+}
+
+bool Crossword::assign_(
+    Domains &domains, std::size_t slot, std::size_t word, std::vector<std::uint32_t> &changed
+) const {
+  const std::size_t k = word / 64;
+  const std::uint64_t bit = 1ULL << (word % 64);
+  const auto domain = domain_(domains, slot);
+  std::fill(domain.begin(), domain.end(), 0ULL);
+  domain[k] = bit;
+
+  // Answers are distinct, so the word leaves every other slot of its length.
+  changed.assign(1, std::uint32_t(slot));
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    if (s == slot || layout_.slots[s].length != layout_.slots[slot].length) {
+      continue;
+    }
+    auto &block = domain_(domains, s)[k];
+    if (block & bit) {
+      block &= ~bit;
+      changed.push_back(std::uint32_t(s));
+      if (popcount(domain_(domains, s)) == 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::size_t Crossword::candidateIndex_(std::size_t length, std::string_view word) const noexcept {
+  if (length >= lengthWords_.size() || word.size() != length) {
+    return std::numeric_limits<std::size_t>::max();
+  }
+  const auto &candidates = lengthWords_[length];
+  const auto it = std::ranges::find_if(candidates, [word](std::string_view candidate) {
+    return std::ranges::equal(candidate, word, [](char a, char b) {
+      return (a & ~0x20) == (b & ~0x20);
+    });
+  });
+  return it == candidates.end() ? std::numeric_limits<std::size_t>::max()
+                                : std::size_t(it - candidates.begin());
+}
+
+std::size_t Crossword::nextSlot_(
+    Domains &domains, const std::vector<bool> &assigned, SearchState &state
+) const {
+  // Slots are ranked lexicographically, lowest first.
+  std::size_t best = layout_.slots.size();
+  std::array<std::uint64_t, 3> bestRank = {};
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    if (assigned[s]) {
+      continue;
+    }
+    const std::uint64_t count = popcount(domain_(domains, s));
+    const std::uint64_t tie = state.options.seed != 0 ? state.random() : s;
+    std::array<std::uint64_t, 3> rank = {count, 0, tie};
+    if (state.options.slotOrder == SlotOrder::ORDER_MOST_CROSSINGS) {
+      const auto crossings = layout_.crossingsOf(s);
+      rank[1] = std::uint64_t(std::ranges::count_if(crossings, [&assigned](const Crossing &crossing) {
+        return assigned[crossing.slot];
+      }));
+    } else if (state.options.slotOrder == SlotOrder::ORDER_LONGEST) {
+      rank = {UINT8_MAX - std::uint64_t(layout_.slots[s].length), count, tie};
+    }
+    if (best == layout_.slots.size() || rank < bestRank) {
+      best = s;
+      bestRank = rank;
+    }
+  }
+  return best;
+}
+
+bool Crossword::stopped_(SearchState &state) const noexcept {
+  // Reading the clock costs more than a node, so the deadline is checked sparingly.
+  constexpr std::size_t deadlinePeriod = 32;
+  const bool cancelled = state.options.cancelled != nullptr &&
+                         state.options.cancelled->load(std::memory_order_relaxed);
+  if (!state.expired && state.nodes % deadlinePeriod == 1 &&
+      state.options.deadline != std::chrono::steady_clock::time_point::max()) {
+    state.expired = std::chrono::steady_clock::now() >= state.options.deadline;
+  }
+  return cancelled || state.expired || state.nodes > state.options.maxNodes;
+}
+
+bool Crossword::search_(Domains &domains, std::vector<bool> &assigned, SearchState &state) const {
+  ++state.nodes;
+  if (stopped_(state)) {
+    return false;
+  }
+  const std::size_t best = nextSlot_(domains, assigned, state);
+  if (best == layout_.slots.size()) {
+    return true;
+  }
+
+  std::vector<std::uint32_t> candidates = {};
+  const auto domain = domain_(domains, best);
+  for (std::size_t k = 0; k < domain.size(); ++k) {
+    for (std::uint64_t bits = domain[k]; bits != 0; bits &= bits - 1) {
+      candidates.push_back(std::uint32_t(k * 64 + std::size_t(std::countr_zero(bits))));
+    }
+  }
+  if (state.options.candidateOrder == CandidateOrder::ORDER_RANDOM) {
+    std::shuffle(candidates.begin(), candidates.end(), state.random);
+  }
+
+  std::vector<std::uint32_t> changed = {};
+  for (const auto word : candidates) {
+    Domains trial = domains;
+    assigned[best] = true;
+    if (!assign_(trial, best, word, changed) || !propagate_(trial, changed)) {
+      assigned[best] = false;
+      continue;
+    }
+    const std::size_t depth = std::size_t(std::ranges::count(assigned, true));
+    if (depth > state.deepest) {
+      state.deepest = depth;
+      state.deepestDomains = trial;
+      state.deepestAssigned = assigned;
+    }
+    if (search_(trial, assigned, state)) {
+      domains = std::move(trial);
+      return true;
+    }
+    assigned[best] = false;
+    if (stopped_(state)) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool Crossword::run_(const SearchOptions &options, Domains &domains, bool &exhausted) const {
+  SearchState state = {options, std::mt19937_64(options.seed)};
+  return run_(state, domains, exhausted);
+}
+
+bool Crossword::run_(SearchState &state, Domains &domains, bool &exhausted) const {
+  exhausted = !consistent_;
+  if (!consistent_) {
+    return false;
+  }
+  domains = domains_;
+  std::vector<bool> assigned(layout_.slots.size());
+  const bool solved = search_(domains, assigned, state);
+  exhausted = !solved && !stopped_(state);
+  return solved;
+}
+
+std::string_view Crossword::firstCandidate_(Domains &domains, std::size_t slot) const noexcept {
+  const auto domain = domain_(domains, slot);
+  const auto block = std::ranges::find_if(domain, [](std::uint64_t bits) {
+    return bits != 0;
+  });
+  WSR_ASSERT(block != domain.end());
+  const std::size_t word = std::size_t(block - domain.begin()) * 64 +
+                           std::size_t(std::countr_zero(*block));
+  return lengthWords_[layout_.slots[slot].length][word];
+}
+
+std::vector<std::string_view> Crossword::fill_(Domains &domains) const {
+  std::vector<std::string_view> words = {};
+  words.reserve(layout_.slots.size());
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    words.push_back(firstCandidate_(domains, s));
+  }
+  return words;
+}
+
+std::span<const Slot> Crossword::slots() const noexcept {
+  return layout_.slots;
+}
+
+bool Crossword::consistent() const noexcept {
+  return consistent_;
+}
+
+std::size_t Crossword::candidateCount(std::size_t slot) const noexcept {
+  WSR_ASSERT(slot < layout_.slots.size());
+  return popcount(std::span(domains_).subspan(domainsBegin_[slot], blockCount_(slot)));
+}
+
+bool Crossword::hasCandidate(std::size_t slot, std::string_view word) const noexcept {
+  WSR_ASSERT(slot < layout_.slots.size());
+  const std::size_t index = candidateIndex_(layout_.slots[slot].length, word);
+  if (index == std::numeric_limits<std::size_t>::max()) {
+    return false;
+  }
+  return (domains_[domainsBegin_[slot] + index / 64] >> (index % 64)) & 1U;
+}
+
+double Crossword::prior_(std::size_t length, std::size_t index, std::size_t rank) const noexcept {
+  return lengthFrequencies_.empty() ? 1.0 / double(rank + 1)
+                                    : double(lengthFrequencies_[length][index]) + 1.0;
+}
+
+double Crossword::confidence(std::size_t slot, std::string_view word) const noexcept {
+  WSR_ASSERT(slot < layout_.slots.size());
+  const std::size_t length = layout_.slots[slot].length;
+  const std::size_t index = candidateIndex_(length, word);
+  if (!hasCandidate(slot, word)) {
+    return 0.0;
+  }
+  const auto domain = std::span(domains_).subspan(domainsBegin_[slot], blockCount_(slot));
+  double total = 0.0;
+  std::size_t rank = 0;
+  for (std::size_t k = 0; k < domain.size(); ++k) {
+    for (std::uint64_t bits = domain[k]; bits != 0; bits &= bits - 1) {
+      total += prior_(length, k * 64 + std::size_t(std::countr_zero(bits)), rank++);
+    }
+  }
+  return prior_(length, index, frequencyRank(slot, word)) / total;
+}
+
+void Crossword::rankCandidates(std::size_t slot, std::vector<RankedCandidate> &candidates) const {
+  WSR_ASSERT(slot < layout_.slots.size());
+  const std::size_t length = layout_.slots[slot].length;
+  const auto domain = std::span(domains_).subspan(domainsBegin_[slot], blockCount_(slot));
+  candidates.clear();
+  double total = 0.0;
+  for (std::size_t k = 0; k < domain.size(); ++k) {
+    for (std::uint64_t bits = domain[k]; bits != 0; bits &= bits - 1) {
+      const std::size_t index = k * 64 + std::size_t(std::countr_zero(bits));
+      const double prior = prior_(length, index, candidates.size());
+      candidates.push_back({lengthWords_[length][index], prior});
+      total += prior;
+    }
+  }
+  for (auto &candidate : candidates) {
+    candidate.probability /= total;
+  }
+}
+
+std::size_t Crossword::supportCount(std::size_t slot, std::size_t position, char letter) const noexcept {
+  WSR_ASSERT(slot < layout_.slots.size() && position < layout_.slots[slot].length);
+  const std::size_t index = letterIndex(letter);
+  if (index >= alphaCount) {
+    return 0;
+  }
+  const auto domain = std::span(domains_).subspan(domainsBegin_[slot], blockCount_(slot));
+  const auto allowed = candidatesWith_(layout_.slots[slot].length, position, index);
+  std::size_t count = 0;
+  for (std::size_t k = 0; k < domain.size(); ++k) {
+    count += std::size_t(std::popcount(domain[k] & allowed[k]));
+  }
+  return count;
+}
+
+std::span<const Crossing> Crossword::crossingsOf(std::size_t slot) const noexcept {
+  return layout_.crossingsOf(slot);
+}
+
+bool Crossword::reveal(Point cell, char letter) {
+  const std::size_t index = letterIndex(letter);
+  std::vector<std::uint32_t> changed = {};
+  for (std::size_t s = 0; s < layout_.slots.size() && index < alphaCount; ++s) {
+    const Slot &slot = layout_.slots[s];
+    const int offset = slot.vertical ? cell.y - slot.y : cell.x - slot.x;
+    const bool inLine = slot.vertical ? cell.x == slot.x : cell.y == slot.y;
+    if (!inLine || offset < 0 || offset >= slot.length) {
+      continue;
+    }
+    const auto domain = domain_(domains_, s);
+    const auto allowed = candidatesWith_(slot.length, std::size_t(offset), index);
+    for (std::size_t k = 0; k < domain.size(); ++k) {
+      domain[k] &= allowed[k];
+    }
+    consistent_ = consistent_ && popcount(domain) > 0;
+    changed.push_back(std::uint32_t(s));
+  }
+  consistent_ = consistent_ && propagate_(domains_, changed);
+  return consistent_;
+}
+
+bool Crossword::assign(std::size_t slot, std::string_view word) {
+  WSR_ASSERT(slot < layout_.slots.size());
+  std::vector<std::uint32_t> changed = {};
+  consistent_ = consistent_ && hasCandidate(slot, word) &&
+                assign_(domains_, slot, candidateIndex_(layout_.slots[slot].length, word), changed) &&
+                propagate_(domains_, changed);
+  return consistent_;
+}
+
+bool Crossword::exclude(std::string_view word) {
+  std::vector<std::uint32_t> changed = {};
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    if (!hasCandidate(s, word)) {
+      continue;
+    }
+    const std::size_t index = candidateIndex_(layout_.slots[s].length, word);
+    const auto domain = domain_(domains_, s);
+    domain[index / 64] &= ~(1ULL << (index % 64));
+    consistent_ = consistent_ && popcount(domain) > 0;
+    changed.push_back(std::uint32_t(s));
+  }
+  consistent_ = consistent_ && propagate_(domains_, changed);
+  return consistent_;
+}
+
+std::optional<std::vector<std::string_view>> Crossword::solve(const SearchOptions &options) const {
+  WSR_PROFILE_SCOPE();
+  Domains domains = {};
+  bool exhausted = false;
+  if (!run_(options, domains, exhausted)) {
+    return std::nullopt;
+  }
+  return fill_(domains);
+}
+
+CrosswordFill Crossword::solveAnytime(const SearchOptions &options) const {
+  WSR_PROFILE_SCOPE();
+  CrosswordFill fill = {std::vector<std::string_view>(layout_.slots.size())};
+  SearchState state = {options, std::mt19937_64(options.seed)};
+  Domains domains = {};
+  bool exhausted = false;
+  if (run_(state, domains, exhausted)) {
+    fill.words = fill_(domains);
+    fill.complete = true;
+    return fill;
+  }
+  if (exhausted) {
+    return fill;
+  }
+
+  // Without any guess, only the slots propagation already decided are kept.
+  Domains &partial = state.deepest > 0 ? state.deepestDomains : domains;
+  for (std::size_t s = 0; s < layout_.slots.size(); ++s) {
+    const bool filled = state.deepest > 0 && state.deepestAssigned[s];
+    if (filled || popcount(domain_(partial, s)) == 1) {
+      fill.words[s] = firstCandidate_(partial, s);
+    }
+  }
+  return fill;
+}
+
+std::size_t Crossword::frequencyRank(std::size_t slot, std::string_view word) const noexcept {
+  WSR_ASSERT(slot < layout_.slots.size());
+  const std::size_t index = std::min(
+      candidateIndex_(layout_.slots[slot].length, word), lengthWords_[layout_.slots[slot].length].size()
+  );
+  const auto domain = std::span(domains_).subspan(domainsBegin_[slot], blockCount_(slot));
+  std::size_t rank = 0;
+  for (std::size_t k = 0; k < domain.size() && k * 64 < index; ++k) {
+    const std::size_t below = std::min<std::size_t>(index - k * 64, 64);
+    const std::uint64_t mask = below == 64 ? ~0ULL : (1ULL << below) - 1;
+    rank += std::size_t(std::popcount(domain[k] & mask));
+  }
+  return rank;
+}
+
+std::optional<std::vector<std::string_view>> Crossword::solveParallel(
+    utils::ThreadPool &pool, std::size_t maxNodes
+) const {
+  constexpr std::size_t firstRestartNodes = 256;
+  constexpr std::array<SlotOrder, 3> slotOrders = {
+      SlotOrder::ORDER_FEWEST_CANDIDATES, SlotOrder::ORDER_MOST_CROSSINGS, SlotOrder::ORDER_LONGEST
+  };
+  WSR_PROFILE_SCOPE();
+  if (!consistent_) {
+    return std::nullopt;
+  }
+
+  std::atomic<bool> cancelled = false;
+  std::mutex fillMutex = {};
+  Domains fill = {};
+  bool solved = false;
+
+  // Returns whether the portfolio is done, either filled or proven unfillable.
+  const auto runSearch = [&](const SearchOptions &options) {
+    Domains domains = {};
+    bool exhausted = false;
+    const bool found = run_(options, domains, exhausted);
+    if (found) {
+      std::lock_guard lock(fillMutex);
+      if (!solved) {
+        fill = std::move(domains);
+        solved = true;
+      }
+    }
+    if (found || exhausted) {
+      cancelled = true;
+    }
+    return found || exhausted || cancelled.load();
+  };
+
+  // Frequency-first searches under each slot order, then restarted searches
+  // with shuffled candidates on the remaining workers.
+  std::vector<std::future<void>> searches = {};
+  for (const auto slotOrder : slotOrders) {
+    searches.push_back(pool.submit([&, slotOrder] {
+      runSearch({slotOrder, CandidateOrder::ORDER_FREQUENCY, maxNodes, 0, &cancelled});
+    }));
+  }
+  const std::size_t restartWorkers = std::max<std::size_t>(pool.size(), slotOrders.size() + 1) -
+                                     slotOrders.size();
+  for (std::size_t worker = 0; worker < restartWorkers; ++worker) {
+    searches.push_back(pool.submit([&, worker] {
+      std::uint64_t seed = (worker + 1) << 32;
+      for (std::size_t budget = firstRestartNodes;; budget = std::min(budget * 2, maxNodes)) {
+        const SearchOptions options = {
+            SlotOrder::ORDER_FEWEST_CANDIDATES, CandidateOrder::ORDER_RANDOM, budget, ++seed, &cancelled
+        };
+        if (runSearch(options) || budget == maxNodes) {
+          return;
+        }
+      }
+    }));
+  }
+  for (auto &search : searches) {
+    search.get();
+  }
+
+  if (!solved) {
+    return std::nullopt;
+  }
+  return fill_(fill);
+}
+
+}  // namespace wsr::detail
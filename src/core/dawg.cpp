@@ -0,0 +1,194 @@
+/**
+ * dawg.cpp
+ *
+ * Implementation for dawg.hpp
+ */
+
+#include "core/dawg.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+constexpr std::size_t alphaCount = 26;
+constexpr std::uint32_t letterMask = 0x1FU;
+constexpr std::uint32_t finalBit = 1U << 5;
+constexpr std::uint32_t targetShift = 6;
+
+// Returns alphaCount for non-alphabetic characters.
+std::size_t letterIndex(char c) noexcept {
+  const char upper = char(c & ~0x20);
+  return upper >= 'A' && upper <= 'Z' ? std::size_t(upper - 'A') : alphaCount;
+}
+
+struct BuildNode {
+  std::vector<std::pair<std::uint8_t, std::uint32_t>> edges = {};  // (letter, child)
+  bool terminal = {};
+};
+
+// Equal keys identify equivalent nodes once their children are minimized.
+std::string nodeKey(const BuildNode &node) {
+  std::string key(1, char(node.terminal));
+  for (const auto &[letter, child] : node.edges) {
+    key.push_back(char(letter));
+    key.append(reinterpret_cast<const char *>(&child), sizeof(child));
+  }
+  return key;
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+Dawg::Dawg(std::span<const DawgNode> nodes, std::span<const DawgEdge> edges) :
+    nodes_(nodes), edges_(edges) {
+  WSR_EXCEPTMSG(tableErrMsg) = "DAWG node table does not match its edge table.";
+  utils::runtimeRequire(
+      nodes_.empty() || nodes_.back().edgesBegin == edges_.size(), WSR_EXCEPTION(tableErrMsg)
+  );
+}
+
+std::size_t Dawg::size() const noexcept {
+  return nodes_.empty() ? 0 : nodes_.front().wordCount;
+}
+
+void Dawg::generate(
+    std::string_view letters, const WordFilter &filter, std::vector<std::uint32_t> &ranks
+) const {
+  WSR_PROFILE_SCOPE();
+  std::array<std::uint8_t, alphaCount + 1> counts = {};
+  for (const char c : letters) {
+    ++counts[letterIndex(c)];
+  }
+  counts[alphaCount] = 0;  // Non-alphabetic letters spell nothing.
+
+  std::size_t minLength = std::max<std::size_t>(filter.minLength, 1);
+  std::size_t maxLength = std::min(filter.maxLength, letters.size());
+  if (!filter.pattern.empty()) {
+    minLength = std::max(minLength, filter.pattern.size());
+    maxLength = std::min(maxLength, filter.pattern.size());
+  }
+  if (nodes_.size() < 2 || minLength > maxLength) {
+    return;
+  }
+
+  const auto search = [&](const auto &self, std::size_t node, std::size_t depth, std::uint32_t rank)
+      -> void {
+    const std::size_t fixed = depth < filter.pattern.size() ? letterIndex(filter.pattern[depth])
+                                                            : alphaCount;
+    for (std::size_t e = nodes_[node].edgesBegin; e < nodes_[node + 1].edgesBegin; ++e) {
+      const DawgEdge edge = edges_[e];
+      const std::size_t letter = edge.transition & letterMask;
+      if (counts[letter] == 0 || (fixed != alphaCount && fixed != letter)) {
+        continue;
+      }
+      const std::uint32_t target = edge.transition >> targetShift;
+      const std::uint32_t ends = (edge.transition & finalBit) ? 1U : 0U;
+      const std::uint32_t edgeRank = rank + edge.rankOffset;
+      --counts[letter];
+      if (ends && depth + 1 >= minLength) {
+        ranks.push_back(edgeRank);
+      }
+      if (depth + 1 < maxLength && nodes_[target].wordCount > 0) {
+        self(self, target, depth + 1, edgeRank + ends);
+      }
+      ++counts[letter];
+    }
+  };
+  search(search, 0, 0, 0);
+}
+
+std::pair<std::vector<DawgNode>, std::vector<DawgEdge>> Dawg::build(
+    std::span<const std::string_view> words
+) {
+  WSR_EXCEPTMSG(letterErrMsg) = "DAWG words must be non-empty and alphabetic.";
+  WSR_EXCEPTMSG(orderErrMsg) = "DAWG words must be distinct and sorted.";
+  WSR_EXCEPTMSG(sizeErrMsg) = "DAWG is too large to encode.";
+  WSR_PROFILE_SCOPE();
+  const auto letterLess = [](char a, char b) {
+    return letterIndex(a) < letterIndex(b);
+  };
+
+  std::vector<BuildNode> nodes(1);
+  std::unordered_map<std::string, std::uint32_t> registry = {};
+  std::vector<std::uint32_t> path = {0};  // Nodes spelling the previous word.
+
+  // Replaces the nodes below a depth on the previous word's path with registered
+  // equivalents. Replaced nodes become unreachable and are never emitted.
+  const auto minimize = [&](std::size_t depth) {
+    while (path.size() > depth + 1) {
+      const std::uint32_t child = path.back();
+      path.pop_back();
+      const auto [it, inserted] = registry.try_emplace(nodeKey(nodes[child]), child);
+      if (!inserted) {
+        nodes[path.back()].edges.back().second = it->second;
+      }
+    }
+  };
+
+  std::string_view previous = {};
+  for (const auto word : words) {
+    const bool alphabetic = std::ranges::all_of(word, [](char c) {
+      return letterIndex(c) < alphaCount;
+    });
+    utils::runtimeRequire(!word.empty() && alphabetic, WSR_EXCEPTION(letterErrMsg));
+    const bool ordered = std::lexicographical_compare(
+        previous.begin(), previous.end(), word.begin(), word.end(), letterLess
+    );
+    utils::runtimeRequire(ordered, WSR_EXCEPTION(orderErrMsg));
+
+    const auto mismatch = std::mismatch(
+        previous.begin(), previous.end(), word.begin(), word.end(), [](char a, char b) {
+          return letterIndex(a) == letterIndex(b);
+        }
+    );
+    const std::size_t common = std::size_t(mismatch.second - word.begin());
+    minimize(common);
+    for (std::size_t i = common; i < word.size(); ++i) {
+      const auto child = std::uint32_t(nodes.size());
+      nodes.emplace_back();
+      nodes[path.back()].edges.emplace_back(std::uint8_t(letterIndex(word[i])), child);
+      path.push_back(child);
+    }
+    nodes[path.back()].terminal = true;
+    previous = word;
+  }
+  minimize(0);
+
+  // Number reachable nodes depth-first from the root, then count their words.
+  constexpr std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> order = {};
+  std::vector<std::uint32_t> index(nodes.size(), unvisited);
+  std::vector<std::uint32_t> wordCounts(nodes.size());
+  const auto visit = [&](const auto &self, std::uint32_t node) -> void {
+    index[node] = std::uint32_t(order.size());
+    order.push_back(node);
+    for (const auto &[letter, child] : nodes[node].edges) {
+      if (index[child] == unvisited) {
+        self(self, child);
+      }
+      wordCounts[node] += std::uint32_t(nodes[child].terminal) + wordCounts[child];
+    }
+  };
+  visit(visit, 0);
+  utils::runtimeRequire(order.size() < (1U << (32 - targetShift)), WSR_EXCEPTION(sizeErrMsg));
+
+  std::vector<DawgNode> dawgNodes = {};
+  std::vector<DawgEdge> dawgEdges = {};
+  dawgNodes.reserve(order.size() + 1);
+  for (const auto node : order) {
+    dawgNodes.emplace_back(std::uint32_t(dawgEdges.size()), wordCounts[node]);
+    std::uint32_t rankOffset = 0;
+    for (const auto &[letter, child] : nodes[node].edges) {
+      const std::uint32_t ends = nodes[child].terminal ? 1U : 0U;
+      const std::uint32_t transition = (index[child] << targetShift) | (ends ? finalBit : 0U) | letter;
+      dawgEdges.emplace_back(transition, rankOffset);
+      rankOffset += ends + wordCounts[child];
+    }
+  }
+  dawgNodes.emplace_back(std::uint32_t(dawgEdges.size()), 0U);  // Sentinel ending the last node.
+  return {std::move(dawgNodes), std::move(dawgEdges)};
+}
+
+}  // namespace wsr::detail
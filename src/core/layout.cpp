@@ -0,0 +1,199 @@
+/**
+ * layout.cpp
+ *
+ * Implementation for layout.hpp
+ */
+
+#include "core/layout.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+template <typename CellAt>
+std::optional<wsr::detail::LayoutKey> makeKey(
+    std::size_t width, std::size_t height, CellAt cellAt
+) noexcept {
+  using wsr::detail::LayoutKey;
+  if (width > UINT8_MAX || height > UINT8_MAX || width * height > LayoutKey::maxCells) {
+    return std::nullopt;
+  }
+  LayoutKey key = {};
+  key.width = std::uint8_t(width);
+  key.height = std::uint8_t(height);
+  for (std::size_t y = 0; y < height; ++y) {
+    for (std::size_t x = 0; x < width; ++x) {
+      if (wsr::detail::isOccupied(cellAt(x, y))) {
+        const std::size_t bit = y * width + x;
+        key.bits[bit / LayoutKey::wordBits] |= 1ULL << (bit % LayoutKey::wordBits);
+      }
+    }
+  }
+  return key;
+}
+
+using HammingKernel = void (*)(
+    const wsr::detail::LayoutBits &,
+    std::span<const wsr::detail::LayoutBits>,
+    std::span<std::uint16_t>
+) noexcept;
+
+void hammingScalar(
+    const wsr::detail::LayoutBits &layout,
+    std::span<const wsr::detail::LayoutBits> candidates,
+    std::span<std::uint16_t> out
+) noexcept {
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    int distance = 0;
+    for (std::size_t w = 0; w < layout.size(); ++w) {
+      distance += std::popcount(layout[w] ^ candidates[i][w]);
+    }
+    out[i] = std::uint16_t(distance);
+  }
+}
+
+/**
+ * Nibble lookup popcount over one 256-bit register per candidate.
+ */
+WSR_TARGET_AVX2 void hammingAvx2(
+    const wsr::detail::LayoutBits &layout,
+    std::span<const wsr::detail::LayoutBits> candidates,
+    std::span<std::uint16_t> out
+) noexcept {
+  static_assert(sizeof(wsr::detail::LayoutBits) == sizeof(__m256i));
+  const __m256i nibbleCounts = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+  );
+  const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+  const __m256i query = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(layout.data()));
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    const __m256i candidate =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(candidates[i].data()));
+    const __m256i diff = _mm256_xor_si256(query, candidate);
+    const __m256i low = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(diff, lowNibble));
+    const __m256i high = _mm256_shuffle_epi8(
+        nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(diff, 4), lowNibble)
+    );
+    const __m256i sums = _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+    const __m128i halves =
+        _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    const __m128i total = _mm_add_epi64(halves, _mm_unpackhi_epi64(halves, halves));
+    out[i] = std::uint16_t(_mm_cvtsi128_si32(total));
+  }
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+std::optional<LayoutKey> LayoutKey::fromGrid(const Matrix<char> &grid) noexcept {
+  const auto &data = grid.data();
+  return makeKey(grid.sizeX(), grid.sizeY(), [&data, &grid](std::size_t x, std::size_t y) {
+    return data[y * grid.sizeX() + x];
+  });
+}
+
+std::optional<LayoutKey> LayoutKey::fromString(
+    std::size_t width, std::size_t height, std::string_view layout
+) noexcept {
+  if (layout.size() != width * height) {
+    return std::nullopt;
+  }
+  return makeKey(width, height, [layout, width](std::size_t x, std::size_t y) {
+    return layout[y * width + x];
+  });
+}
+
+std::uint64_t LayoutKey::hash() const noexcept {
+  std::uint64_t hash = utils::hashMix(std::uint64_t(width) | std::uint64_t(height) << 8);
+  for (const auto word : bits) {
+    hash = utils::hashMix(hash ^ word);
+  }
+  return hash;
+}
+
+std::vector<Slot> findSlots(const LayoutKey &key) {
+  std::vector<Slot> slots = {};
+  for (const bool vertical : {false, true}) {
+    const std::size_t lines = vertical ? key.width : key.height;
+    const std::size_t lineLength = vertical ? key.height : key.width;
+    for (std::size_t line = 0; line < lines; ++line) {
+      std::size_t run = 0;
+      for (std::size_t i = 0; i <= lineLength; ++i) {
+        const bool occupied = i < lineLength &&
+                              (vertical ? key.occupied(line, i) : key.occupied(i, line));
+        if (occupied) {
+          ++run;
+          continue;
+        }
+        if (run >= 2) {
+          const std::size_t start = i - run;
+          slots.push_back(Slot{
+              std::uint8_t(vertical ? line : start),
+              std::uint8_t(vertical ? start : line),
+              std::uint8_t(run),
+              vertical
+          });
+        }
+        run = 0;
+      }
+    }
+  }
+  std::stable_sort(slots.begin(), slots.end(), [](const auto &a, const auto &b) {
+    return std::tuple(a.vertical, a.y, a.x) < std::tuple(b.vertical, b.y, b.x);
+  });
+  return slots;
+}
+
+LayoutStructure analyzeLayout(const LayoutKey &key) {
+  constexpr std::uint32_t noSlot = std::numeric_limits<std::uint32_t>::max();
+  LayoutStructure layout = {findSlots(key)};
+  const auto &slots = layout.slots;
+
+  // Horizontal slots come first, so every crossing pairs one with a vertical slot.
+  std::vector<std::pair<std::uint32_t, std::uint8_t>> horizontal(
+      std::size_t(key.width) * key.height, {noSlot, 0}
+  );
+  std::vector<std::vector<Crossing>> slotCrossings(slots.size());
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    for (std::size_t i = 0; i < slots[s].length; ++i) {
+      const Point cell = slots[s].cell(i);
+      auto &owner = horizontal[std::size_t(cell.y) * key.width + std::size_t(cell.x)];
+      if (!slots[s].vertical) {
+        owner = {std::uint32_t(s), std::uint8_t(i)};
+      } else if (owner.first != noSlot) {
+        slotCrossings[owner.first].push_back({std::uint32_t(s), 0U, owner.second, std::uint8_t(i)});
+        slotCrossings[s].push_back({owner.first, 0U, std::uint8_t(i), owner.second});
+      }
+    }
+  }
+  layout.crossingsBegin.push_back(0);
+  for (const auto &list : slotCrossings) {
+    layout.crossings.insert(layout.crossings.end(), list.begin(), list.end());
+    layout.crossingsBegin.push_back(std::uint32_t(layout.crossings.size()));
+  }
+
+  // Two slots cross at most once.
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    for (std::uint32_t c = layout.crossingsBegin[s]; c < layout.crossingsBegin[s + 1]; ++c) {
+      const std::uint32_t other = layout.crossings[c].slot;
+      for (std::uint32_t r = layout.crossingsBegin[other]; r < layout.crossingsBegin[other + 1]; ++r) {
+        if (layout.crossings[r].slot == s) {
+          layout.crossings[c].reverse = r;
+        }
+      }
+    }
+  }
+  return layout;
+}
+
+void hammingDistances(
+    const LayoutBits &layout, std::span<const LayoutBits> candidates, std::span<std::uint16_t> out
+) noexcept {
+  WSR_ASSERT(candidates.size() <= out.size());
+  static const HammingKernel kernel = utils::cpuSupportsAvx2() ? hammingAvx2 : hammingScalar;
+  kernel(layout, candidates, out);
+}
+
+}  // namespace wsr::detail
@@ -0,0 +1,121 @@
+/**
+ * perfect_hash.cpp
+ *
+ * Implementation for perfect_hash.hpp
+ */
+
+#include "core/perfect_hash.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+constexpr std::size_t averageBucketSize = 4;
+constexpr std::uint32_t maxPilot = 1U << 24;
+constexpr std::uint64_t maxAttempts = 16;
+
+std::size_t bucketOf(std::uint64_t keyHash, const wsr::detail::PerfectHashParams &params) {
+  return wsr::utils::hashMix(keyHash ^ params.seed) % params.bucketCount;
+}
+
+std::size_t slotOf(
+    std::uint64_t keyHash, std::uint32_t pilot, const wsr::detail::PerfectHashParams &params
+) {
+  const std::uint64_t displaced = keyHash ^ ~params.seed ^ wsr::utils::hashMix(pilot);
+  return wsr::utils::hashMix(displaced) % params.slotCount;
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+PerfectHash::PerfectHash(PerfectHashParams params, std::span<const std::uint32_t> pilots) :
+    params_(params), pilots_(pilots) {
+  WSR_EXCEPTMSG(pilotErrMsg) = "Perfect hash pilot count does not match its bucket count.";
+  utils::runtimeRequire(pilots_.size() == params_.bucketCount, WSR_EXCEPTION(pilotErrMsg));
+}
+
+std::size_t PerfectHash::size() const noexcept {
+  return params_.slotCount;
+}
+
+std::size_t PerfectHash::operator()(std::uint64_t keyHash) const noexcept {
+  WSR_ASSERT(params_.slotCount > 0);
+  return slotOf(keyHash, pilots_[bucketOf(keyHash, params_)], params_);
+}
+
+std::pair<PerfectHashParams, std::vector<std::uint32_t>> PerfectHash::build(
+    std::span<const std::uint64_t> keyHashes
+) {
+  WSR_EXCEPTMSG(buildErrMsg) = "Perfect hash construction failed. Are the key hashes distinct?";
+  WSR_PROFILE_SCOPE();
+  utils::runtimeRequire(keyHashes.size() <= UINT32_MAX, WSR_EXCEPTION(buildErrMsg));
+  if (keyHashes.empty()) {
+    return {PerfectHashParams{0, 1, 0}, std::vector<std::uint32_t>(1)};
+  }
+  std::vector<std::uint64_t> sortedHashes(keyHashes.begin(), keyHashes.end());
+  std::sort(sortedHashes.begin(), sortedHashes.end());
+  const bool distinct = std::adjacent_find(sortedHashes.begin(), sortedHashes.end()) ==
+                        sortedHashes.end();
+  utils::runtimeRequire(distinct, WSR_EXCEPTION(buildErrMsg));
+
+  PerfectHashParams params = {};
+  params.slotCount = std::uint32_t(keyHashes.size());
+  params.bucketCount = std::uint32_t(keyHashes.size() / averageBucketSize + 1);
+
+  for (std::uint64_t attempt = 0; attempt < maxAttempts; ++attempt) {
+    params.seed = utils::hashMix(attempt + 1);
+
+    std::vector<std::vector<std::uint64_t>> buckets(params.bucketCount);
+    for (const auto keyHash : keyHashes) {
+      buckets[bucketOf(keyHash, params)].push_back(keyHash);
+    }
+    std::vector<std::uint32_t> order(params.bucketCount);
+    std::iota(order.begin(), order.end(), 0U);
+    std::stable_sort(order.begin(), order.end(), [&buckets](auto a, auto b) {
+      return buckets[a].size() > buckets[b].size();  // Largest buckets are hardest to place.
+    });
+
+    std::vector<std::uint32_t> pilots(params.bucketCount);
+    std::vector<bool> taken(params.slotCount);
+    std::vector<std::size_t> slots = {};
+    bool placed = true;
+    for (const auto bucketIdx : order) {
+      const auto &bucket = buckets[bucketIdx];
+      if (bucket.empty()) {
+        break;
+      }
+      bool found = false;
+      for (std::uint32_t pilot = 0; pilot < maxPilot && !found; ++pilot) {
+        slots.clear();
+        found = true;
+        for (const auto keyHash : bucket) {
+          const std::size_t slot = slotOf(keyHash, pilot, params);
+          if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            found = false;
+            break;
+          }
+          slots.push_back(slot);
+        }
+        if (found) {
+          pilots[bucketIdx] = pilot;
+        }
+      }
+      if (!found) {
+        placed = false;
+        break;
+      }
+      for (const auto slot : slots) {
+        taken[slot] = true;
+      }
+    }
+    if (placed) {
+      return {params, std::move(pilots)};
+    }
+  }
+  utils::runtimeRequire(false, WSR_EXCEPTION(buildErrMsg));
+  return {};
+}
+
+}  // namespace wsr::detail
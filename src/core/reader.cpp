@@ -40,25 +40,163 @@ bool isEntryQualified(const fs::directory_entry &entry) {
 }
 
 /**
- * Matches a template with a given template and its inverse, and returns the
- * largest confidence score of either inverse or not.
+ * Packs a binary image, set where a pixel is at least half intensity.
  */
-float matchTemplateWInv(const cv::Mat &roi, const cv::Mat &tmplt) {
-  WSR_ASSERT(roi.rows == tmplt.rows && roi.cols == tmplt.cols);
-  WSR_ASSERT(roi.type() == tmplt.type() && roi.type() == CV_8UC1);
+wsr::PackedGlyph packGlyph(const cv::Mat &binary) {
+  WSR_ASSERT(binary.type() == CV_8UC1);
+  WSR_ASSERT(std::size_t(binary.rows * binary.cols) == wsr::PackedGlyph().size() * 64);
+  wsr::PackedGlyph glyph = {};
+  std::size_t bit = 0;
+  for (int y = {}; y < binary.rows; ++y) {
+    const std::uint8_t *row = binary.ptr<std::uint8_t>(y);
+    for (int x = {}; x < binary.cols; ++x, ++bit) {
+      glyph[bit / 64] |= std::uint64_t(row[x] >= 128) << (bit % 64);
+    }
+  }
+  return glyph;
+}
 
-  int accuDiff = 0;
-  int accuInvDiff = 0;
-  for (int y = {}; y < roi.rows; ++y) {
-    for (int x = {}; x < roi.cols; ++x) {
-      const std::size_t idx = std::size_t(y * roi.cols + x);
-      accuDiff += std::abs(roi.data[idx] - tmplt.data[idx]);
-      accuInvDiff += std::abs(roi.data[idx] - (UINT8_MAX - tmplt.data[idx]));
+/**
+ * Copies a grayscale image row by row, optionally inverted.
+ */
+void copyGlyph(const cv::Mat &gray, std::span<std::uint8_t> pixels, bool inverted = false) {
+  WSR_ASSERT(gray.type() == CV_8UC1);
+  WSR_ASSERT(std::size_t(gray.rows * gray.cols) == pixels.size());
+  auto out = pixels.begin();
+  for (int y = {}; y < gray.rows; ++y) {
+    const std::uint8_t *row = gray.ptr<std::uint8_t>(y);
+    if (inverted) {
+      out = std::transform(row, row + gray.cols, out, [](std::uint8_t p) {
+        return std::uint8_t(UINT8_MAX - p);
+      });
+    } else {
+      out = std::copy(row, row + gray.cols, out);
+    }
+  }
+}
+
+/**
+ * Rescales a normalized distance to a template and its inverse to a confidence score.
+ */
+float confidenceOf(float conf) {
+  return ((1.0f - std::min(conf, 1.0f - conf)) - 0.5f) / 0.5f;
+}
+
+template <std::size_t Side>
+using SadKernel =
+    void (*)(const std::uint8_t *, const std::uint8_t *, std::size_t, std::uint32_t *) noexcept;
+
+/**
+ * Sums of absolute differences between a glyph and each of the count glyphs in
+ * the atlas, 16 pixels per psadbw. Glyphs are Side * Side pixels, 64-byte
+ * aligned and back to back, so every trip count is known at compile time.
+ */
+template <std::size_t Side>
+void sadSse2(
+    const std::uint8_t *glyph, const std::uint8_t *atlas, std::size_t count, std::uint32_t *out
+) noexcept {
+  constexpr std::size_t pixelCount = Side * Side;
+  static_assert(pixelCount % 64 == 0);
+  for (std::size_t i = 0; i < count; ++i, atlas += pixelCount) {
+    __m128i sums = _mm_setzero_si128();
+    for (std::size_t p = 0; p < pixelCount; p += 16) {
+      const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(glyph + p));
+      const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(atlas + p));
+      sums = _mm_add_epi64(sums, _mm_sad_epu8(a, b));
+    }
+    sums = _mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums));
+    out[i] = std::uint32_t(_mm_cvtsi128_si32(sums));
+  }
+}
+
+/**
+ * Same as sadSse2, 32 pixels at a time.
+ */
+template <std::size_t Side>
+WSR_TARGET_AVX2 void sadAvx2(
+    const std::uint8_t *glyph, const std::uint8_t *atlas, std::size_t count, std::uint32_t *out
+) noexcept {
+  constexpr std::size_t pixelCount = Side * Side;
+  static_assert(pixelCount % 64 == 0);
+  for (std::size_t i = 0; i < count; ++i, atlas += pixelCount) {
+    __m256i sums = _mm256_setzero_si256();
+    for (std::size_t p = 0; p < pixelCount; p += 32) {
+      const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(glyph + p));
+      const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i *>(atlas + p));
+      sums = _mm256_add_epi64(sums, _mm256_sad_epu8(a, b));
     }
+    __m128i halves =
+        _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    halves = _mm_add_epi64(halves, _mm_unpackhi_epi64(halves, halves));
+    out[i] = std::uint32_t(_mm_cvtsi128_si32(halves));
   }
-  const int diff = std::min(accuDiff, accuInvDiff);
-  float conf = float(diff) / (roi.rows * roi.cols * UINT8_MAX);  // Normalize.
-  return ((1.0f - std::min(conf, 1.0f - conf)) - 0.5f) / 0.5f;   // Rescale.
+}
+
+template <std::size_t Side>
+void sadDistances(
+    const std::uint8_t *glyph, const std::uint8_t *atlas, std::size_t count, std::uint32_t *out
+) noexcept {
+  static const SadKernel<Side> kernel =
+      wsr::utils::cpuSupportsAvx2() ? sadAvx2<Side> : sadSse2<Side>;
+  kernel(glyph, atlas, count, out);
+}
+
+/**
+ * Sums the pixels of every 8x8 cell of a Side x Side glyph, 8 pixels per
+ * psadbw against zero. The L1 distance between the sums of two glyphs is at
+ * most the sum of absolute differences between their pixels, so it bounds
+ * that distance.
+ */
+template <std::size_t Side>
+wsr::GlyphBlocks blockSums(const std::uint8_t *pixels) noexcept {
+  constexpr std::size_t cellSide = 8;
+  constexpr std::size_t cellsPerRow = Side / cellSide;
+  static_assert(Side % 16 == 0 && cellsPerRow * cellsPerRow == wsr::GlyphBlocks().size());
+  wsr::GlyphBlocks blocks = {};
+  for (std::size_t cellY = 0; cellY < cellsPerRow; ++cellY) {
+    for (std::size_t x = 0; x < Side; x += 16) {
+      __m128i sums = _mm_setzero_si128();
+      for (std::size_t y = cellY * cellSide; y < (cellY + 1) * cellSide; ++y) {
+        const auto *row = reinterpret_cast<const __m128i *>(pixels + y * Side + x);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_load_si128(row), _mm_setzero_si128()));
+      }
+      blocks[cellY * cellsPerRow + x / cellSide] = std::uint16_t(_mm_cvtsi128_si32(sums));
+      blocks[cellY * cellsPerRow + x / cellSide + 1] = std::uint16_t(_mm_extract_epi16(sums, 4));
+    }
+  }
+  return blocks;
+}
+
+std::uint32_t blockDistance(const wsr::GlyphBlocks &a, const wsr::GlyphBlocks &b) noexcept {
+  std::uint32_t distance = 0;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    distance += std::uint32_t(std::abs(int(a[i]) - int(b[i])));
+  }
+  return distance;
+}
+
+std::uint64_t glyphHash(const wsr::PackedGlyph &glyph) noexcept {
+  std::uint64_t hash = 0;
+  for (const auto word : glyph) {
+    hash = wsr::utils::hashMix(hash ^ word);
+  }
+  return hash;
+}
+
+/**
+ * Matches a glyph with a given template and its inverse, and returns the
+ * largest confidence score of either inverse or not. Pixels differ by either
+ * zero or full intensity, so the distance to the inverse template is the pixel
+ * count minus the distance to the template.
+ */
+float matchTemplateWInv(const wsr::PackedGlyph &roi, const wsr::PackedGlyph &tmplt) {
+  constexpr int pixelCount = int(wsr::PackedGlyph().size() * 64);
+  int accuDiff = 0;
+  for (std::size_t i = 0; i < roi.size(); ++i) {
+    accuDiff += std::popcount(roi[i] ^ tmplt[i]);
+  }
+  const int diff = std::min(accuDiff, pixelCount - accuDiff);
+  return confidenceOf(float(diff) / pixelCount);
 }
 
 /**
@@ -89,7 +227,8 @@ Reader::Reader() {
   const fs::path dataPath = utils::getRoot() / "data" / "templates";
   std::vector<char> names = {};
 
-  templates_.reserve(alphaCount);
+  std::vector<cv::Mat> templates = {};
+  templates.reserve(alphaCount);
   names.reserve(alphaCount);
   for (const auto &entry : fs::directory_iterator(dataPath)) {
     if (!isEntryQualified(entry)) {
@@ -112,12 +251,71 @@ Reader::Reader() {
     utils::runtimeRequire(matchedRows && matchedCols, WSR_EXCEPTION(tmpInvalidErrMsg));
 
     std::string entryPathStr = entryPath.filename().string();
-    templates_.push_back(std::move(templateImg));
+    templates.push_back(std::move(templateImg));
     names.push_back(entryPathStr[0]);
     utils::logMessage(utils::LogSeverity::LOG_INFO, std::format("Loaded file: {}", entryPathStr));
   }
-  utils::runtimeRequire(templates_.size() == alphaCount, WSR_EXCEPTION(tmpMissingErrMsg));
-  sortTemplates(names, templates_);
+  utils::runtimeRequire(templates.size() == alphaCount, WSR_EXCEPTION(tmpMissingErrMsg));
+  sortTemplates(names, templates);
+
+  // Binarized once here, so matching compares bits.
+  templates_.reserve(alphaCount);
+  for (const auto &templateImg : templates) {
+    templates_.push_back(packGlyph(templateImg));
+  }
+
+  // Grayscale copies kept as loaded, with the inverses precomputed after them.
+  atlas_.resize(alphaCount * 2);
+  for (std::size_t i = 0; i < alphaCount; ++i) {
+    copyGlyph(templates[i], atlas_[i].pixels);
+    copyGlyph(templates[i], atlas_[alphaCount + i].pixels, true);
+  }
+  atlasBlocks_.reserve(atlas_.size());
+  for (const auto &glyph : atlas_) {
+    atlasBlocks_.push_back(blockSums<templateSideLength_>(glyph.pixels.data()));
+  }
+  glyphCache_.resize(glyphCacheSize_);
+}
+
+std::pair<float, char> Reader::matchGlyph_(const cv::Mat &binary) const {
+  const PackedGlyph glyph = packGlyph(binary);
+  const std::uint64_t hash = glyphHash(glyph);
+  constexpr std::size_t setCount = glyphCacheSize_ / glyphCacheWays_;
+  const std::span<GlyphCacheEntry, glyphCacheWays_> set(
+      glyphCache_.begin() + std::ptrdiff_t(hash % setCount * glyphCacheWays_), glyphCacheWays_
+  );
+  {
+    std::shared_lock lock(glyphCacheMutex_);
+    for (const auto &entry : set) {
+      if (entry.letter != 0 && entry.glyph == glyph) {
+        glyphCacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return {entry.confidence, entry.letter};
+      }
+    }
+  }
+  glyphCacheMisses_.fetch_add(1, std::memory_order_relaxed);
+
+  char maxCh = 'A';
+  float maxConfidence = 0.0f;
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    const float conf = matchTemplateWInv(glyph, templates_[c - 'A']);
+    if (maxConfidence < conf) {
+      maxConfidence = conf;
+      maxCh = c;
+    }
+  }
+  // Another thread may have added the glyph since it was looked up.
+  std::lock_guard lock(glyphCacheMutex_);
+  for (const auto &entry : set) {
+    if (entry.letter != 0 && entry.glyph == glyph) {
+      return {entry.confidence, entry.letter};
+    }
+  }
+  const auto empty = std::ranges::find(set, char(0), &GlyphCacheEntry::letter);
+  const std::size_t way = empty != set.end() ? std::size_t(empty - set.begin())
+                                             : std::size_t(hash / setCount % glyphCacheWays_);
+  set[way] = {glyph, maxConfidence, maxCh};
+  return {maxConfidence, maxCh};
 }
 
 std::pair<float, char> Reader::match(const cv::Mat &image, cv::Rect bbox) const {
@@ -138,21 +336,144 @@ std::pair<float, char> Reader::match(const cv::Mat &image, cv::Rect bbox) const
   cv::resize(roi, roi, cv::Size(templateSideLength_, templateSideLength_));
   cv::threshold(roi, roi, 128, 255, cv::THRESH_OTSU);
 
-  WSR_IMGSHOW(roi);
-  
+  const auto [maxConfidence, maxCh] = matchGlyph_(roi);
+  utils::logMessage(
+      utils::LogSeverity::LOG_DEBUG, std::format("'{}': {:.2f}%", maxCh, maxConfidence * 100.0f)
+  );
+  return {maxConfidence, maxCh};
+}
+
+void Reader::matchMany(
+    const cv::Mat &image,
+    std::span<const cv::Rect> bboxes,
+    std::vector<std::pair<float, char>> &matches
+) const {
+  WSR_ASSERT(image.type() == CV_8UC3 || image.type() == CV_8UC1);
+  WSR_PROFILE_SCOPE();
+  // Kept per thread, so the buffers only grow with the first batches.
+  thread_local cv::Mat gray = {};
+  thread_local cv::Mat glyph = {};
+
+  const cv::Mat *source = &image;
+  if (image.type() == CV_8UC3) {
+    cv::cvtColor(image, gray, cv::COLOR_RGB2GRAY);
+    source = &gray;
+  }
+  matches.clear();
+  matches.reserve(bboxes.size());
+  for (const auto &bbox : bboxes) {
+    WSR_ASSERT(bbox.x >= 0 && bbox.y >= 0);
+    WSR_ASSERT(bbox.x + bbox.width <= image.cols && bbox.y + bbox.height <= image.rows);
+    cv::resize((*source)(bbox), glyph, cv::Size(templateSideLength_, templateSideLength_));
+    cv::threshold(glyph, glyph, 128, 255, cv::THRESH_OTSU);
+    matches.push_back(matchGlyph_(glyph));
+  }
+}
+
+std::pair<float, char> Reader::matchGrayscale(const cv::Mat &image, cv::Rect bbox) const {
+  WSR_ASSERT(bbox.x >= 0 && bbox.y >= 0);
+  WSR_ASSERT(bbox.x + bbox.width <= image.cols && bbox.y + bbox.height <= image.rows);
+  WSR_ASSERT(image.type() == CV_8UC3 || image.type() == CV_8UC1);
+  WSR_PROFILE_SCOPE();
+
+  cv::Mat roi = {};
+  switch (image.type()) {
+    case CV_8UC3:
+      cv::cvtColor(image(bbox), roi, cv::COLOR_RGB2GRAY);
+      break;
+    case CV_8UC1:
+      roi = image(bbox).clone();
+      break;
+  }
+  cv::resize(roi, roi, cv::Size(templateSideLength_, templateSideLength_));
+
+  GrayGlyph glyph = {};
+  copyGlyph(roi, glyph.pixels);
+  const auto [maxConfidence, maxCh] = cascade_ ? matchCascade_(glyph) : matchExhaustive_(glyph);
+  utils::logMessage(
+      utils::LogSeverity::LOG_DEBUG, std::format("'{}': {:.2f}%", maxCh, maxConfidence * 100.0f)
+  );
+  return {maxConfidence, maxCh};
+}
+
+void Reader::setCascade(bool enabled) noexcept {
+  cascade_ = enabled;
+}
+
+GlyphCacheStats Reader::glyphCacheStats() const noexcept {
+  return {
+      glyphCacheHits_.load(std::memory_order_relaxed),
+      glyphCacheMisses_.load(std::memory_order_relaxed)
+  };
+}
+
+std::pair<float, char> Reader::matchExhaustive_(const GrayGlyph &glyph) const {
+  std::array<std::uint32_t, alphaCount * 2> sads = {};
+  sadDistances<templateSideLength_>(
+      glyph.pixels.data(), atlas_.front().pixels.data(), atlas_.size(), sads.data()
+  );
+
+  constexpr float maxDistance = float(templateSideLength_ * templateSideLength_ * UINT8_MAX);
   char maxCh = 'A';
   float maxConfidence = 0.0f;
-  for (char c = 'A'; c <= 'Z'; ++c) {
-    const float conf = matchTemplateWInv(roi, templates_[c - 'A']);
+  for (std::size_t i = 0; i < alphaCount; ++i) {
+    const float conf = confidenceOf(float(std::min(sads[i], sads[alphaCount + i])) / maxDistance);
     if (maxConfidence < conf) {
       maxConfidence = conf;
-      maxCh = c;
+      maxCh = char('A' + i);
     }
   }
-  utils::logMessage(
-      utils::LogSeverity::LOG_DEBUG, std::format("'{}': {:.2f}%", maxCh, maxConfidence * 100.0f)
-  );
   return {maxConfidence, maxCh};
 }
 
-}  // namespace wsr
\ No newline at end of file
+std::pair<float, char> Reader::matchCascade_(const GrayGlyph &glyph) const {
+  WSR_PROFILE_SCOPE();
+  constexpr float maxDistance = float(templateSideLength_ * templateSideLength_ * UINT8_MAX);
+  const auto confidence = [](std::uint32_t distance) {
+    return confidenceOf(float(distance) / maxDistance);
+  };
+
+  // Bounds on the distance to every atlas glyph, and to each letter either way.
+  const GlyphBlocks blocks = blockSums<templateSideLength_>(glyph.pixels.data());
+  std::array<std::uint32_t, alphaCount * 2> bounds = {};
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    bounds[i] = blockDistance(blocks, atlasBlocks_[i]);
+  }
+  std::array<std::uint8_t, alphaCount> order = {};
+  std::iota(order.begin(), order.end(), std::uint8_t(0));
+  const auto letterBound = [&bounds](std::size_t i) {
+    return std::min(bounds[i], bounds[alphaCount + i]);
+  };
+  std::sort(order.begin(), order.end(), [&letterBound](auto a, auto b) {
+    return letterBound(a) < letterBound(b);
+  });
+
+  // Confidence falls as the distance grows, so once a letter's bound scores
+  // below the best letter, neither it nor any later letter can win. Ties go
+  // to the earlier letter, as in the exhaustive match.
+  std::size_t best = alphaCount;
+  float maxConfidence = 0.0f;
+  for (const std::size_t i : order) {
+    const float boundConfidence = confidence(letterBound(i));
+    if (boundConfidence <= 0.0f || boundConfidence < maxConfidence) {
+      break;
+    }
+    std::uint32_t distance = UINT32_MAX;
+    for (const std::size_t entry : {i, alphaCount + i}) {
+      if (confidence(bounds[entry]) < maxConfidence) {
+        continue;
+      }
+      std::uint32_t sad = {};
+      sadDistances<templateSideLength_>(glyph.pixels.data(), atlas_[entry].pixels.data(), 1, &sad);
+      distance = std::min(distance, sad);
+    }
+    const float conf = confidence(distance);
+    if (maxConfidence < conf || (maxConfidence == conf && conf > 0.0f && i < best)) {
+      maxConfidence = conf;
+      best = i;
+    }
+  }
+  return {maxConfidence, best == alphaCount ? 'A' : char('A' + best)};
+}
+
+}  // namespace wsr
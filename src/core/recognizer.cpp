@@ -39,11 +39,13 @@ std::pair<float, std::string> readWord(
     return aYBin < bYBin;
   });
 
+  std::vector<std::pair<float, char>> matches = {};
+  reader.matchMany(thresh, bboxes, matches);
+
   std::string str = {};
   int cbbox = 0;
   float strConf = {};
-  for (const auto &bbox : bboxes) {
-    const auto [conf, ch] = reader.match(thresh, bbox);
+  for (const auto &[conf, ch] : matches) {
     if (conf <= confLimit) {
       continue;
     }
@@ -150,19 +152,24 @@ std::vector<std::pair<char, cv::Rect>> findWheelLetters(
   std::vector<std::vector<cv::Point>> contours = {};
   cv::findContours(letterWheel, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
-  std::vector<std::pair<char, cv::Rect>> letters = {};
+  std::vector<cv::Rect> bboxes = {};
+  bboxes.reserve(contours.size());
   for (const auto &contour : contours) {
     const cv::Rect bbox = cv::boundingRect(contour);
-    const cv::Size bboxSize = bbox.size();
-
-    if (bboxSize.area() < noiseThreshArea) {
-      continue;
+    if (bbox.size().area() >= noiseThreshArea) {
+      bboxes.push_back(bbox);
     }
-    const auto [conf, ch] = reader.match(letterWheel, bbox);
+  }
+  std::vector<std::pair<float, char>> matches = {};
+  reader.matchMany(letterWheel, bboxes, matches);
+
+  std::vector<std::pair<char, cv::Rect>> letters = {};
+  for (std::size_t i = 0; i < bboxes.size(); ++i) {
+    const auto [conf, ch] = matches[i];
     if (conf < 0.8) {
       continue;
     }
-    letters.emplace_back(std::pair<char, cv::Rect>(ch, bbox));
+    letters.emplace_back(std::pair<char, cv::Rect>(ch, bboxes[i]));
   }
   if (!wsr::utils::inRange(letters.size(), minLetters, maxLetters)) {
     return {};
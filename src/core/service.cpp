@@ -0,0 +1,374 @@
+/**
+ * service.cpp
+ *
+ * Implementation for service.hpp
+ */
+
+#include "core/service.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+constexpr std::size_t requestHeaderSize = 3;
+constexpr std::size_t responseHeaderSize = 2;
+
+bool isLetter(char c) noexcept {
+  return c >= 'A' && c <= 'Z';
+}
+
+// Runs a function once it goes out of scope, however the scope is left.
+template <typename F>
+class ScopeExit {
+  F function_;
+
+ public:
+  explicit ScopeExit(F function) : function_(std::move(function)) {}
+  ScopeExit(const ScopeExit &) = delete;
+  ScopeExit &operator=(const ScopeExit &) = delete;
+  ~ScopeExit() {
+    function_();
+  }
+};
+
+void appendByte(std::vector<std::byte> &message, std::size_t value) {
+  message.push_back(std::byte(value & 0xFF));
+}
+
+// Appends the size prefix of a payload, to be patched once the payload is written.
+std::size_t beginFrame(std::vector<std::byte> &message) {
+  const std::size_t begin = message.size();
+  message.resize(begin + wsr::detail::messageSizeBytes);
+  return begin;
+}
+
+void endFrame(std::vector<std::byte> &message, std::size_t begin) {
+  WSR_EXCEPTMSG(sizeErrMsg) = "Service message exceeds the maximum size.";
+  const std::size_t size = message.size() - begin - wsr::detail::messageSizeBytes;
+  wsr::utils::runtimeRequire(size <= wsr::detail::maxMessageSize, WSR_EXCEPTION(sizeErrMsg));
+  message[begin] = std::byte(size & 0xFF);
+  message[begin + 1] = std::byte(size >> 8);
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+void encodeRequest(const Matrix<char> &grid, std::string_view letters, std::vector<std::byte> &message) {
+  WSR_EXCEPTMSG(levelErrMsg) = "Level is too large to be sent to the service.";
+  utils::runtimeRequire(
+      grid.sizeX() <= UINT8_MAX && grid.sizeY() <= UINT8_MAX && letters.size() <= UINT8_MAX,
+      WSR_EXCEPTION(levelErrMsg)
+  );
+  const std::size_t begin = beginFrame(message);
+  appendByte(message, grid.sizeX());
+  appendByte(message, grid.sizeY());
+  appendByte(message, letters.size());
+  for (int y = 0; std::size_t(y) < grid.sizeY(); ++y) {
+    for (int x = 0; std::size_t(x) < grid.sizeX(); ++x) {
+      message.push_back(std::byte(grid[{x, y}]));
+    }
+  }
+  for (const char c : letters) {
+    message.push_back(std::byte(c));
+  }
+  endFrame(message, begin);
+}
+
+void encodeResponse(const SolveResponse &response, std::vector<std::byte> &message) {
+  WSR_EXCEPTMSG(answersErrMsg) = "Response holds too many answers.";
+  utils::runtimeRequire(response.paths.size() <= maxResponseAnswers, WSR_EXCEPTION(answersErrMsg));
+  const std::size_t begin = beginFrame(message);
+  appendByte(message, std::size_t(response.status));
+  appendByte(message, response.paths.size());
+  for (const auto &path : response.paths) {
+    appendByte(message, path.size());
+    for (const auto position : path) {
+      appendByte(message, position);
+    }
+  }
+  endFrame(message, begin);
+}
+
+std::optional<std::pair<Matrix<char>, std::string>> decodeRequest(std::span<const std::byte> payload) {
+  if (payload.size() < requestHeaderSize) {
+    return std::nullopt;
+  }
+  const auto width = std::size_t(payload[0]);
+  const auto height = std::size_t(payload[1]);
+  const auto letterCount = std::size_t(payload[2]);
+  if (payload.size() != requestHeaderSize + width * height + letterCount) {
+    return std::nullopt;
+  }
+
+  // Cells are empty, blank tiles or revealed letters, and letters are uppercase.
+  std::pair<Matrix<char>, std::string> request = {Matrix<char>(width, height), {}};
+  const std::byte *cell = payload.data() + requestHeaderSize;
+  for (int y = 0; std::size_t(y) < height; ++y) {
+    for (int x = 0; std::size_t(x) < width; ++x) {
+      const auto c = char(*cell++);
+      if (c != '0' && c != '1' && !isLetter(c)) {
+        return std::nullopt;
+      }
+      request.first[{x, y}] = c;
+    }
+  }
+  request.second.resize(letterCount);
+  std::memcpy(request.second.data(), cell, letterCount);
+  if (!std::ranges::all_of(request.second, isLetter)) {
+    return std::nullopt;
+  }
+  return request;
+}
+
+std::optional<SolveResponse> decodeResponse(std::span<const std::byte> payload) {
+  if (payload.size() < responseHeaderSize) {
+    return std::nullopt;
+  }
+  SolveResponse response = {ServiceStatus(payload[0])};
+  const auto count = std::size_t(payload[1]);
+  std::size_t offset = responseHeaderSize;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (offset >= payload.size()) {
+      return std::nullopt;
+    }
+    const auto length = std::size_t(payload[offset++]);
+    if (payload.size() - offset < length) {
+      return std::nullopt;
+    }
+    WheelPath &path = response.paths.emplace_back(length);
+    std::memcpy(path.data(), payload.data() + offset, length);
+    offset += length;
+  }
+  if (offset != payload.size()) {
+    return std::nullopt;
+  }
+  return response;
+}
+
+Winsock::Winsock() {
+  WSR_EXCEPTMSG(startupErrMsg) = "Winsock cannot be initialized.";
+  WSADATA data = {};
+  utils::windowsRequire(WSAStartup(MAKEWORD(2, 2), &data) == 0, WSR_EXCEPTION(startupErrMsg));
+}
+
+Winsock::~Winsock() {
+  WSACleanup();
+}
+
+Socket::Socket(SOCKET handle) noexcept : handle_(handle) {}
+
+Socket::Socket(Socket &&other) noexcept : handle_(std::exchange(other.handle_, INVALID_SOCKET)) {}
+
+Socket &Socket::operator=(Socket &&other) noexcept {
+  if (this != &other) {
+    if (handle_ != INVALID_SOCKET) {
+      closesocket(handle_);
+    }
+    handle_ = std::exchange(other.handle_, INVALID_SOCKET);
+  }
+  return *this;
+}
+
+Socket::~Socket() {
+  if (handle_ != INVALID_SOCKET) {
+    closesocket(handle_);
+  }
+}
+
+SOCKET Socket::get() const noexcept {
+  return handle_;
+}
+
+bool Socket::receive(std::vector<std::byte> &payload) const {
+  const auto receiveAll = [this](std::byte *data, std::size_t size) {
+    while (size > 0) {
+      const int received = recv(handle_, reinterpret_cast<char *>(data), int(size), 0);
+      if (received <= 0) {
+        return false;
+      }
+      data += received;
+      size -= std::size_t(received);
+    }
+    return true;
+  };
+  std::array<std::byte, messageSizeBytes> prefix = {};
+  if (!receiveAll(prefix.data(), prefix.size())) {
+    return false;
+  }
+  payload.resize(std::size_t(prefix[0]) | (std::size_t(prefix[1]) << 8));
+  return receiveAll(payload.data(), payload.size());
+}
+
+bool Socket::send(std::span<const std::byte> bytes) const {
+  while (!bytes.empty()) {
+    const int sent = ::send(handle_, reinterpret_cast<const char *>(bytes.data()), int(bytes.size()), 0);
+    if (sent <= 0) {
+      return false;
+    }
+    bytes = bytes.subspan(std::size_t(sent));
+  }
+  return true;
+}
+
+}  // namespace wsr::detail
+
+namespace wsr {
+
+namespace {
+
+sockaddr_un socketAddress(const std::filesystem::path &socketPath) {
+  WSR_EXCEPTMSG(pathErrMsg) = "Socket path is too long.";
+  const std::string path = socketPath.string();
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  utils::runtimeRequire(path.size() < sizeof(address.sun_path), WSR_EXCEPTION(pathErrMsg));
+  std::memcpy(address.sun_path, path.data(), path.size());
+  return address;
+}
+
+}  // namespace
+
+SolverService::SolverService(const std::filesystem::path &socketPath, std::size_t threadCount)
+    : socketPath_(socketPath), pool_(threadCount) {
+  WSR_EXCEPTMSG(socketErrMsg) = "Service socket cannot be created.";
+  WSR_EXCEPTMSG(bindErrMsg) = "Service socket cannot be bound.";
+  WSR_EXCEPTMSG(listenErrMsg) = "Service socket cannot listen.";
+  WSR_PROFILE_SCOPE();
+
+  const sockaddr_un address = socketAddress(socketPath_);
+  std::error_code error = {};
+  std::filesystem::remove(socketPath_, error);
+  listener_ = detail::Socket(socket(AF_UNIX, SOCK_STREAM, 0));
+  utils::windowsRequire(listener_.get() != INVALID_SOCKET, WSR_EXCEPTION(socketErrMsg));
+  utils::windowsRequire(
+      bind(listener_.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != SOCKET_ERROR,
+      WSR_EXCEPTION(bindErrMsg)
+  );
+  utils::windowsRequire(listen(listener_.get(), SOMAXCONN) != SOCKET_ERROR, WSR_EXCEPTION(listenErrMsg));
+  utils::logMessage(
+      utils::LogSeverity::LOG_INFO,
+      std::format("Solver service listening on {} with {} threads.", socketPath_.string(), pool_.size())
+  );
+}
+
+SolverService::~SolverService() {
+  stop();
+  std::error_code error = {};
+  std::filesystem::remove(socketPath_, error);
+}
+
+std::filesystem::path SolverService::defaultSocketPath() {
+  return std::filesystem::temp_directory_path() / defaultSocketName;
+}
+
+void SolverService::serve_(detail::Socket client) {
+  WSR_LOGMSG(logMalformedRequest) = "Service received a malformed request.";
+  WSR_LOGMSG(logSolveFailed) = "Service could not solve a request.";
+  WSR_LOGMSG(logTooManyAnswers) = "Service found more answers than a response holds.";
+  WSR_PROFILE_SCOPE();
+  // Forgotten before the socket closes on every way out, so stop never shuts
+  // down a handle Winsock has given to a newer connection.
+  const ScopeExit forgetClient([this, handle = client.get()] {
+    std::lock_guard lock(clientsMutex_);
+    std::erase(clients_, handle);
+  });
+
+  std::vector<std::byte> payload = {};
+  std::vector<std::byte> message = {};
+  while (client.receive(payload)) {
+    detail::SolveResponse response = {};
+    const auto request = detail::decodeRequest(payload);
+    if (!request.has_value()) {
+      utils::logMessage(utils::LogSeverity::LOG_ERROR, logMalformedRequest);
+      response.status = detail::ServiceStatus::STATUS_BAD_REQUEST;
+    } else {
+      try {
+        for (const auto word : solver_.solve(request->first, request->second)) {
+          if (auto path = detail::wheelPath(word, request->second)) {
+            response.paths.push_back(std::move(*path));
+          }
+        }
+        if (response.paths.size() > detail::maxResponseAnswers) {
+          utils::logMessage(utils::LogSeverity::LOG_ERROR, logTooManyAnswers);
+          response = {detail::ServiceStatus::STATUS_BAD_REQUEST};
+        }
+      } catch (const std::exception &) {
+        utils::logMessage(utils::LogSeverity::LOG_ERROR, logSolveFailed);
+        response = {detail::ServiceStatus::STATUS_BAD_REQUEST};
+      }
+    }
+    message.clear();
+    detail::encodeResponse(response, message);
+    if (!client.send(message)) {
+      break;
+    }
+  }
+}
+
+void SolverService::run() {
+  WSR_LOGMSG(logAcceptFailed) = "Service could not accept a client.";
+  const SOCKET listener = listener_.get();
+  while (!stopping_) {
+    detail::Socket client(accept(listener, nullptr, nullptr));
+    if (client.get() == INVALID_SOCKET) {
+      if (!stopping_) {
+        utils::logMessage(utils::LogSeverity::LOG_ERROR, logAcceptFailed);
+      }
+      continue;
+    }
+    {
+      std::lock_guard lock(clientsMutex_);
+      if (stopping_) {
+        break;
+      }
+      clients_.push_back(client.get());
+    }
+    pool_.submit([this, client = std::move(client)]() mutable { serve_(std::move(client)); });
+  }
+}
+
+void SolverService::stop() {
+  if (stopping_.exchange(true)) {
+    return;
+  }
+  // Closing the listener wakes the accepting thread, and shutting clients down
+  // ends their pending reads.
+  shutdown(listener_.get(), SD_BOTH);
+  listener_ = {};
+  std::lock_guard lock(clientsMutex_);
+  for (const auto client : clients_) {
+    shutdown(client, SD_BOTH);
+  }
+}
+
+SolverClient::SolverClient(const std::filesystem::path &socketPath) {
+  WSR_EXCEPTMSG(socketErrMsg) = "Client socket cannot be created.";
+  WSR_EXCEPTMSG(connectErrMsg) = "Solver service cannot be reached.";
+  const sockaddr_un address = socketAddress(socketPath);
+  socket_ = detail::Socket(socket(AF_UNIX, SOCK_STREAM, 0));
+  utils::windowsRequire(socket_.get() != INVALID_SOCKET, WSR_EXCEPTION(socketErrMsg));
+  utils::windowsRequire(
+      connect(socket_.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != SOCKET_ERROR,
+      WSR_EXCEPTION(connectErrMsg)
+  );
+}
+
+std::vector<detail::WheelPath> SolverClient::solve(const Matrix<char> &grid, std::string_view letters) {
+  WSR_EXCEPTMSG(connectionErrMsg) = "Connection to the solver service was lost.";
+  WSR_EXCEPTMSG(responseErrMsg) = "Solver service sent a malformed response.";
+  WSR_EXCEPTMSG(requestErrMsg) = "Solver service rejected the request.";
+  WSR_PROFILE_SCOPE();
+  buffer_.clear();
+  detail::encodeRequest(grid, letters, buffer_);
+  utils::runtimeRequire(socket_.send(buffer_) && socket_.receive(buffer_), WSR_EXCEPTION(connectionErrMsg));
+  std::optional<detail::SolveResponse> response = detail::decodeResponse(buffer_);
+  utils::runtimeRequire(response.has_value(), WSR_EXCEPTION(responseErrMsg));
+  utils::runtimeRequire(
+      response->status == detail::ServiceStatus::STATUS_OK, WSR_EXCEPTION(requestErrMsg)
+  );
+  return std::move(response->paths);
+}
+
+}  // namespace wsr
@@ -0,0 +1,174 @@
+/**
+ * snapshot.cpp
+ *
+ * Implementation for snapshot.hpp
+ */
+
+#include "core/snapshot.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace fs = std::filesystem;
+
+namespace wsr::detail {
+
+MappedFile::MappedFile(const fs::path &path) {
+  WSR_EXCEPTMSG(openErrMsg) = "Snapshot file cannot be opened.";
+  WSR_EXCEPTMSG(sizeErrMsg) = "Snapshot file size cannot be retrieved.";
+  WSR_EXCEPTMSG(emptyErrMsg) = "Snapshot file is empty.";
+  WSR_EXCEPTMSG(mappingErrMsg) = "Snapshot file mapping cannot be created.";
+  WSR_EXCEPTMSG(viewErrMsg) = "Snapshot file view cannot be mapped.";
+  WSR_PROFILE_SCOPE();
+
+  try {
+    file_ = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    utils::windowsRequire(file_ != INVALID_HANDLE_VALUE, WSR_EXCEPTION(openErrMsg));
+    LARGE_INTEGER fileSize = {};
+    utils::windowsRequire(GetFileSizeEx(file_, &fileSize), WSR_EXCEPTION(sizeErrMsg));
+    utils::runtimeRequire(fileSize.QuadPart > 0, WSR_EXCEPTION(emptyErrMsg));
+    size_ = std::size_t(fileSize.QuadPart);
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    utils::windowsRequire(mapping_, WSR_EXCEPTION(mappingErrMsg));
+    data_ = static_cast<const std::byte *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    utils::windowsRequire(data_, WSR_EXCEPTION(viewErrMsg));
+  } catch (...) {
+    if (mapping_) {
+      CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+      CloseHandle(file_);
+    }
+    throw;
+  }
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+  std::swap(file_, other.file_);
+  std::swap(mapping_, other.mapping_);
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (&other == this) {
+    return *this;
+  }
+  std::swap(file_, other.file_);
+  std::swap(mapping_, other.mapping_);
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(file_);
+  }
+}
+
+std::span<const std::byte> MappedFile::bytes() const noexcept {
+  return {data_, size_};
+}
+
+Snapshot::Snapshot(MappedFile mapping) : mapping_(std::move(mapping)) {
+  bytes_ = mapping_.bytes();
+  validate_();
+}
+
+Snapshot::Snapshot(std::vector<std::byte> buffer) : buffer_(std::move(buffer)) {
+  bytes_ = buffer_;
+  validate_();
+}
+
+void Snapshot::validate_() {
+  WSR_EXCEPTMSG(truncatedErrMsg) = "Snapshot is truncated.";
+  WSR_EXCEPTMSG(magicErrMsg) = "Snapshot has an invalid signature.";
+  WSR_EXCEPTMSG(versionErrMsg) = "Snapshot version is not supported.";
+  WSR_EXCEPTMSG(rangeErrMsg) = "Snapshot section is out of bounds.";
+
+  utils::runtimeRequire(bytes_.size() >= sizeof(SnapshotHeader), WSR_EXCEPTION(truncatedErrMsg));
+  std::memcpy(&header_, bytes_.data(), sizeof(SnapshotHeader));
+  utils::runtimeRequire(
+      header_.magic == SnapshotHeader::expectedMagic, WSR_EXCEPTION(magicErrMsg)
+  );
+  utils::runtimeRequire(
+      header_.version == SnapshotHeader::expectedVersion, WSR_EXCEPTION(versionErrMsg)
+  );
+  for (const auto &range : header_.sections) {
+    const bool inBounds = range.offset <= bytes_.size() &&
+                          range.size <= bytes_.size() - range.offset;
+    utils::runtimeRequire(inBounds, WSR_EXCEPTION(rangeErrMsg));
+  }
+}
+
+const SnapshotHeader &Snapshot::header() const noexcept {
+  return header_;
+}
+
+std::size_t Snapshot::size() const noexcept {
+  return bytes_.size();
+}
+
+std::vector<std::byte> SnapshotBuilder::build(
+    SnapshotStamp levelSource, SnapshotStamp dictionarySource
+) const {
+  WSR_PROFILE_SCOPE();
+  const auto alignUp = [](std::size_t value) {
+    return (value + sectionAlignment - 1) & ~(sectionAlignment - 1);
+  };
+
+  SnapshotHeader header = {};
+  header.magic = SnapshotHeader::expectedMagic;
+  header.version = SnapshotHeader::expectedVersion;
+  header.levelSource = levelSource;
+  header.dictionarySource = dictionarySource;
+
+  std::size_t offset = alignUp(sizeof(SnapshotHeader));
+  for (std::size_t i = 0; i < sections_.size(); ++i) {
+    header.sections[i] = {offset, sections_[i].size()};
+    offset = alignUp(offset + sections_[i].size());
+  }
+
+  std::vector<std::byte> image(offset);  // Zero-initialized padding.
+  std::memcpy(image.data(), &header, sizeof(SnapshotHeader));
+  for (std::size_t i = 0; i < sections_.size(); ++i) {
+    std::copy(sections_[i].begin(), sections_[i].end(), image.begin() + header.sections[i].offset);
+  }
+  return image;
+}
+
+SnapshotStamp stampFile(const fs::path &path) {
+  const auto time = fs::last_write_time(path).time_since_epoch().count();
+  return {std::uint64_t(fs::file_size(path)), std::int64_t(time)};
+}
+
+void writeSnapshot(const fs::path &path, std::span<const std::byte> image) {
+  WSR_PROFILE_SCOPE();
+  fs::path temporaryPath = path;
+  temporaryPath += ".tmp";
+  {
+    std::ofstream stream = {};
+    stream.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+    stream.open(temporaryPath, std::ofstream::binary | std::ofstream::trunc);
+    stream.write(reinterpret_cast<const char *>(image.data()), std::streamsize(image.size()));
+  }
+  fs::rename(temporaryPath, path);  // Readers never observe a partially written snapshot.
+}
+
+}  // namespace wsr::detail
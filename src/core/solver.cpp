@@ -6,55 +6,35 @@
 
 #include "core/solver.hpp"
 #include <memory>
+#include "core/crossword.hpp"
 #include "core/pch.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utilities.hpp"
 
 namespace fs = std::filesystem;
 
 namespace {
 
-/**
- * Hashes a given layout string.
- */
-std::size_t hashLayout(std::string_view layout) {
-  constexpr uint32_t prime = 37U;
-  size_t hash = 0;
-  uint32_t powP = prime;
-  for (auto ch : layout) {
-    if (ch != '0' && ch != '1') {
-      ch = '1'; // Handle cases where the board is partially filled.
-    }
-    hash += uint32_t(ch) * powP;
-    powP *= prime;
-  }
-  hash %= (0xFFFFFFFFULL + 1ULL);
-  return hash;
-};
-
 /**
  * Returns a list of the space-separated words found in a section of
  * the passed in data.
  */
-std::vector<std::string_view> getWords(
-    const std::string &data, std::size_t wordsBegin, std::size_t wordsEnd
-) {
-  WSR_ASSERT(wordsBegin <= wordsEnd);
+std::vector<std::string_view> getWords(std::string_view data) {
   constexpr std::size_t averageWordSize = 5;
 
   std::vector<std::string_view> words = {};
-  words.reserve((wordsEnd - wordsBegin) / averageWordSize);
-
-  const auto endIter = data.begin() + wordsEnd;
-  auto wordStartIter = data.begin() + wordsBegin;
-  for (auto iter = wordStartIter; iter != endIter; ++iter) {
-    if (*iter == ' ') {
-      words.emplace_back(wordStartIter, iter);
-      wordStartIter = iter + 1;
+  words.reserve(data.size() / averageWordSize);
+
+  std::size_t wordStart = 0;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    if (data[i] == ' ') {
+      words.emplace_back(data.substr(wordStart, i - wordStart));
+      wordStart = i + 1;
       continue;
     }
   }
-  if (wordStartIter != endIter) {
-    words.emplace_back(wordStartIter, endIter);
+  if (wordStart != data.size()) {
+    words.emplace_back(data.substr(wordStart));
   }
   return words;
 }
@@ -75,10 +55,518 @@ wsr::Matrix<char> getLayoutMatrix(std::size_t w, std::size_t h, std::string_view
   return matrix;
 }
 
+/**
+ * Reads an entire text file into a string.
+ */
+std::string readTextFile(const fs::path &path) {
+  std::ifstream stream = {};
+
+  // ifstream::failbit not set to avoid issues regarding translation.
+  stream.exceptions(std::ifstream::badbit);
+  stream.open(path);
+
+  std::string data = {};
+  const std::size_t fileSize = fs::file_size(path);
+  data.resize(fileSize);  // Zero-initialized.
+  stream.read(data.data(), fileSize);
+
+  // Filesize is greater than true length due to byte->text \r\n translation.
+  data.resize(std::strlen(data.data()));
+  data.shrink_to_fit();
+  return data;
+}
+
+struct DictionarySource {
+  std::string_view view = {};
+  std::uint64_t frequency = {};
+};
+
+struct LevelSource {
+  std::size_t width = {};
+  std::size_t height = {};
+  std::string_view layout = {};
+  std::string_view words = {};
+};
+
+/**
+ * Parses the tab-separated word and frequency pairs of the dictionary.
+ */
+std::vector<DictionarySource> parseDictionaryData(std::string_view data) {
+  WSR_EXCEPTMSG(parseFailErrMsg) = "Failed to parse text file.";
+  WSR_PROFILE_SCOPE();
+  constexpr std::size_t averageLineSize = 12;
+
+  std::vector<DictionarySource> entries = {};
+  entries.reserve(data.size() / averageLineSize);
+
+  for (std::size_t i = 0; i < data.size();) {
+    const std::size_t wordEnd = data.find_first_of('\t', i);
+    wsr::utils::runtimeRequire(wordEnd != data.npos, WSR_EXCEPTION(parseFailErrMsg));
+    const std::size_t numEnd = std::min(data.find_first_of('\n', wordEnd + 1), data.size());
+    const char *pNStart = data.data() + wordEnd + 1;
+    const char *pNEnd = data.data() + numEnd;
+    std::uint64_t frequency = {};
+    const auto fchr = std::from_chars(pNStart, pNEnd, frequency);
+    wsr::utils::runtimeRequire(fchr.ptr == pNEnd, WSR_EXCEPTION(parseFailErrMsg));
+
+    entries.emplace_back(data.substr(i, wordEnd - i), frequency);
+    i = numEnd + 1;
+  }
+  return entries;
+}
+
+/**
+ * Parses the level layouts and their answers.
+ */
+std::vector<LevelSource> parseLevelData(std::string_view data) {
+  WSR_EXCEPTMSG(parseFailErrMsg) = "Failed to parse text file.";
+  WSR_PROFILE_SCOPE();
+  constexpr std::size_t averageLineSize = 150;
+
+  std::vector<LevelSource> levels = {};
+  levels.reserve(data.size() / averageLineSize);
+
+  for (std::size_t i = 0; i < data.size();) {
+    const std::size_t widthEnd = data.find_first_of(' ', i);
+    const std::size_t heightEnd = data.find_first_of(' ', widthEnd + 1);
+    wsr::utils::runtimeRequire(heightEnd != data.npos, WSR_EXCEPTION(parseFailErrMsg));
+
+    std::size_t width = {};
+    std::size_t height = {};
+
+    const char *wStart = data.data() + i;
+    const char *wEnd = data.data() + widthEnd;
+    const char *hStart = data.data() + widthEnd + 1;
+    const char *hEnd = data.data() + heightEnd;
+    const auto wFchr = std::from_chars(wStart, wEnd, width);
+    const auto hFchr = std::from_chars(hStart, hEnd, height);
+
+    wsr::utils::runtimeRequire(wFchr.ptr == wEnd, WSR_EXCEPTION(parseFailErrMsg));
+    wsr::utils::runtimeRequire(hFchr.ptr == hEnd, WSR_EXCEPTION(parseFailErrMsg));
+    wsr::utils::runtimeRequire(
+        width <= UINT8_MAX && height <= UINT8_MAX, WSR_EXCEPTION(parseFailErrMsg)
+    );
+
+    const std::size_t layoutBegin = heightEnd + 1;
+    const std::size_t wordsBegin = layoutBegin + width * height + 1;  // + 1 to skip \t.
+    wsr::utils::runtimeRequire(wordsBegin <= data.size(), WSR_EXCEPTION(parseFailErrMsg));
+    const std::size_t wordsEnd = std::min(data.find_first_of('\n', wordsBegin), data.size());
+
+    const std::string_view layout = data.substr(layoutBegin, width * height);
+    const std::string_view words = data.substr(wordsBegin, wordsEnd - wordsBegin);
+    levels.emplace_back(width, height, layout, words);
+    i = wordsEnd + 1;
+  }
+  return levels;
+}
+
+/**
+ * Splits a buffer into at most chunkCount pieces, each ending on a line boundary.
+ */
+std::vector<std::string_view> splitLines(std::string_view data, std::size_t chunkCount) {
+  WSR_ASSERT(chunkCount > 0);
+  std::vector<std::string_view> chunks = {};
+  chunks.reserve(chunkCount);
+  const std::size_t targetSize = data.size() / chunkCount + 1;
+
+  std::size_t begin = 0;
+  while (begin < data.size()) {
+    const std::size_t target = std::min(begin + targetSize, data.size());
+    const std::size_t newline = data.find_first_of('\n', target - 1);
+    const std::size_t end = newline == data.npos ? data.size() : newline + 1;
+    chunks.push_back(data.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+/**
+ * Parses every chunk of a buffer on the pool and concatenates
+ * the per-chunk results in their original order.
+ */
+template <typename Parser>
+auto parseChunked(wsr::utils::ThreadPool &pool, std::string_view data, Parser parser) {
+  using Result = std::invoke_result_t<Parser, std::string_view>;
+  constexpr std::size_t chunksPerThread = 4;  // Evens out uneven chunk costs.
+
+  std::vector<std::future<Result>> futures = {};
+  for (const auto chunk : splitLines(data, pool.size() * chunksPerThread)) {
+    futures.push_back(pool.submit([chunk, parser] { return parser(chunk); }));
+  }
+  std::vector<Result> parts = {};
+  parts.reserve(futures.size());
+  std::size_t total = 0;
+  for (auto &future : futures) {
+    parts.push_back(future.get());  // Rethrows parse failures.
+    total += parts.back().size();
+  }
+  Result merged = {};
+  merged.reserve(total);
+  for (const auto &part : parts) {
+    merged.insert(merged.end(), part.begin(), part.end());
+  }
+  return merged;
+}
+
+/**
+ * Stable LSD radix sort by descending frequency.
+ * Byte positions shared by every key are skipped.
+ */
+void radixSortByFrequency(std::span<DictionarySource> entries, std::span<DictionarySource> scratch) {
+  WSR_ASSERT(entries.size() == scratch.size());
+  constexpr std::size_t radix = 256;
+  constexpr std::size_t passes = sizeof(std::uint64_t);
+
+  std::uint64_t orBits = 0;
+  std::uint64_t andBits = ~0ULL;
+  for (const auto &entry : entries) {
+    orBits |= ~entry.frequency;  // Inverted key sorts descending.
+    andBits &= ~entry.frequency;
+  }
+  std::span<DictionarySource> source = entries;
+  std::span<DictionarySource> destination = scratch;
+  for (std::size_t pass = 0; pass < passes; ++pass) {
+    const std::size_t shift = pass * CHAR_BIT;
+    if (((orBits ^ andBits) >> shift & 0xFF) == 0) {
+      continue;
+    }
+    std::array<std::size_t, radix> offsets = {};
+    for (const auto &entry : source) {
+      ++offsets[(~entry.frequency >> shift) & 0xFF];
+    }
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), std::size_t(0));
+    for (const auto &entry : source) {
+      destination[offsets[(~entry.frequency >> shift) & 0xFF]++] = entry;
+    }
+    std::swap(source, destination);
+  }
+  if (source.data() != entries.data()) {
+    std::copy(source.begin(), source.end(), entries.begin());
+  }
+}
+
+/**
+ * Orders the dictionary by word length, then by descending frequency.
+ * Entries are bucketed by length with a counting sort, and
+ * each bucket is radix sorted on the pool.
+ */
+void sortDictionary(wsr::utils::ThreadPool &pool, std::vector<DictionarySource> &entries) {
+  WSR_PROFILE_SCOPE();
+  std::size_t maxLength = 0;
+  for (const auto &entry : entries) {
+    maxLength = std::max(maxLength, entry.view.size());
+  }
+  std::vector<std::size_t> offsets(maxLength + 2);
+  for (const auto &entry : entries) {
+    ++offsets[entry.view.size() + 1];
+  }
+  std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<DictionarySource> sorted(entries.size());
+  std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (const auto &entry : entries) {
+    sorted[cursor[entry.view.size()]++] = entry;
+  }
+
+  std::vector<std::future<void>> futures = {};
+  for (std::size_t length = 0; length <= maxLength; ++length) {
+    const std::size_t begin = offsets[length];
+    const std::size_t count = offsets[length + 1] - begin;
+    if (count < 2) {
+      continue;
+    }
+    const std::span<DictionarySource> bucket = std::span(sorted).subspan(begin, count);
+    const std::span<DictionarySource> scratch = std::span(entries).subspan(begin, count);
+    futures.push_back(pool.submit([bucket, scratch] { radixSortByFrequency(bucket, scratch); }));
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+  std::swap(entries, sorted);
+}
+
+/**
+ * Appends a string to a text pool and returns its location.
+ */
+wsr::detail::PoolRef appendToPool(std::string &pool, std::string_view string) {
+  WSR_EXCEPTMSG(poolErrMsg) = "Text pool exceeds 32-bit addressing.";
+  wsr::utils::runtimeRequire(
+      pool.size() + string.size() <= UINT32_MAX, WSR_EXCEPTION(poolErrMsg)
+  );
+  const wsr::detail::PoolRef ref = {std::uint32_t(pool.size()), std::uint32_t(string.size())};
+  pool.append(string);
+  return ref;
+}
+
+// Checks if every cell of a slot already shows its letter.
+bool isSlotRevealed(const wsr::detail::Slot &slot, const wsr::Matrix<char> &grid) noexcept {
+  for (std::size_t i = 0; i < slot.length; ++i) {
+    if (!wsr::detail::isRevealed(grid[slot.cell(i)])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct SlotCandidates {
+  std::vector<std::string_view> words = {};
+  std::vector<std::size_t> frequencies = {};
+};
+
+// Candidate words of a layout's slot lengths spelled from the letters, most frequent first.
+SlotCandidates slotCandidates(
+    const wsr::detail::Database &database,
+    const wsr::detail::LayoutAnalysis &layout,
+    std::string_view letters
+) {
+  // Candidates come from the word graph, most frequent first, so searches
+  // settle on the likeliest consistent fill.
+  wsr::detail::WordFilter slotLengths = {UINT8_MAX, 0};
+  for (const auto &slot : layout.slots) {
+    slotLengths.minLength = std::min<std::size_t>(slotLengths.minLength, slot.length);
+    slotLengths.maxLength = std::max<std::size_t>(slotLengths.maxLength, slot.length);
+  }
+  std::vector<std::uint32_t> ids = {};
+  database.generateIds(letters, slotLengths, ids);
+  SlotCandidates candidates = {};
+  candidates.words.reserve(ids.size());
+  candidates.frequencies.reserve(ids.size());
+  for (const auto id : ids) {
+    const wsr::detail::DictionaryEntry entry = database.entry(id);
+    candidates.words.push_back(entry.view);
+    candidates.frequencies.push_back(entry.frequency);
+  }
+  return candidates;
+}
+
+wsr::RankedAnswer rankAnswer(
+    const wsr::detail::Crossword &crossword, std::size_t slot, std::string_view word
+) noexcept {
+  return {
+      word,
+      crossword.slots()[slot],
+      crossword.candidateCount(slot),
+      crossword.frequencyRank(slot, word),
+      crossword.confidence(slot, word)
+  };
+}
+
+// Scratch space of placeWords. Reused across calls, it stops allocating once
+// it has grown to the largest level placed.
+struct Placement {
+  wsr::Matrix<char> board = {};
+  std::vector<std::string_view> words = {};
+  std::vector<std::size_t> assignment = {};  // Word index of each slot.
+  std::vector<bool> used = {};
+};
+
+/**
+ * Assigns every word to a slot of its length so that crossing cells agree,
+ * both with each other and with the letters already revealed on the grid.
+ * Returns false upon failure, otherwise the placement holds the word index of each slot.
+ */
+bool placeWords(
+    std::span<const wsr::detail::Slot> slots,
+    std::span<const std::string_view> words,
+    const wsr::Matrix<char> &grid,
+    Placement &placement
+) {
+  constexpr std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+  if (slots.size() != words.size()) {
+    return false;
+  }
+  wsr::Matrix<char> &board = placement.board;
+  board.resize(grid.sizeX(), grid.sizeY());
+  for (int y = 0; std::size_t(y) < grid.sizeY(); ++y) {
+    for (int x = 0; std::size_t(x) < grid.sizeX(); ++x) {
+      const char cell = grid[{x, y}];
+      board[{x, y}] = wsr::detail::isRevealed(cell) ? char(cell & ~0x20) : '\0';
+    }
+  }
+  std::vector<std::size_t> &assignment = placement.assignment;
+  std::vector<bool> &used = placement.used;
+  assignment.assign(slots.size(), unassigned);
+  used.assign(words.size(), false);
+
+  const auto fits = [&](const wsr::detail::Slot &slot, std::string_view word) {
+    if (word.size() != slot.length) {
+      return false;
+    }
+    for (std::size_t i = 0; i < word.size(); ++i) {
+      const char cell = board[slot.cell(i)];
+      if (cell != '\0' && cell != char(word[i] & ~0x20)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Depth-first search, always extending the slot with the fewest fitting words.
+  const auto search = [&](const auto &self, std::size_t depth) -> bool {
+    if (depth == slots.size()) {
+      return true;
+    }
+    std::size_t bestSlot = unassigned;
+    std::size_t bestCount = unassigned;
+    for (std::size_t s = 0; s < slots.size() && bestCount > 0; ++s) {
+      if (assignment[s] != unassigned) {
+        continue;
+      }
+      std::size_t count = 0;
+      for (std::size_t w = 0; w < words.size(); ++w) {
+        count += !used[w] && fits(slots[s], words[w]);
+      }
+      if (count < bestCount) {
+        bestCount = count;
+        bestSlot = s;
+      }
+    }
+    if (bestCount == 0) {
+      return false;
+    }
+    const wsr::detail::Slot &slot = slots[bestSlot];
+    for (std::size_t w = 0; w < words.size(); ++w) {
+      if (used[w] || !fits(slot, words[w])) {
+        continue;
+      }
+      std::array<bool, UINT8_MAX + 1> written = {};
+      for (std::size_t i = 0; i < slot.length; ++i) {
+        char &cell = board[slot.cell(i)];
+        written[i] = cell == '\0';
+        cell = char(words[w][i] & ~0x20);
+      }
+      used[w] = true;
+      assignment[bestSlot] = w;
+      if (self(self, depth + 1)) {
+        return true;
+      }
+      assignment[bestSlot] = unassigned;
+      used[w] = false;
+      for (std::size_t i = 0; i < slot.length; ++i) {
+        if (written[i]) {
+          board[slot.cell(i)] = '\0';
+        }
+      }
+    }
+    return false;
+  };
+  return search(search, 0);
+}
+
+// Checks the letters a pattern fixes by position, as WordFilter describes.
+bool matchesPattern(std::string_view word, std::string_view pattern) noexcept {
+  if (pattern.empty()) {
+    return true;
+  }
+  if (word.size() != pattern.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < word.size(); ++i) {
+    const char fixed = char(pattern[i] & ~0x20);
+    if (fixed >= 'A' && fixed <= 'Z' && fixed != char(word[i] & ~0x20)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+using MatchKernel = void (*)(
+    const wsr::detail::LetterCounts &,
+    std::span<const wsr::detail::LetterCounts>,
+    wsr::detail::QueryType,
+    std::span<std::uint8_t>
+) noexcept;
+
+void matchScalar(
+    const wsr::detail::LetterCounts &letters,
+    std::span<const wsr::detail::LetterCounts> candidates,
+    wsr::detail::QueryType type,
+    std::span<std::uint8_t> out
+) noexcept {
+  using wsr::detail::QueryType;
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    bool subset = true;
+    bool superset = true;
+    for (std::size_t c = 0; c < letters.size(); ++c) {
+      subset &= candidates[i][c] <= letters[c];
+      superset &= candidates[i][c] >= letters[c];
+    }
+    switch (type) {
+      case QueryType::QUERY_SUBSETS:
+        out[i] = subset;
+        break;
+      case QueryType::QUERY_SUPERSETS:
+        out[i] = superset;
+        break;
+      case QueryType::QUERY_EQUALITY:
+        out[i] = subset && superset;
+        break;
+      case QueryType::QUERY_INEQUALITY:
+        out[i] = !(subset && superset);
+        break;
+    }
+  }
+}
+
+/**
+ * One 256-bit register per candidate. A saturating subtraction is zero
+ * exactly when no letter count of the minuend exceeds the subtrahend's.
+ */
+template <wsr::detail::QueryType type>
+WSR_TARGET_AVX2 void matchAvx2Impl(
+    const wsr::detail::LetterCounts &letters,
+    std::span<const wsr::detail::LetterCounts> candidates,
+    std::span<std::uint8_t> out
+) noexcept {
+  using wsr::detail::QueryType;
+  static_assert(sizeof(wsr::detail::LetterCounts) == sizeof(__m256i));
+  const __m256i query = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(letters.data()));
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    const __m256i candidate =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(candidates[i].data()));
+    __m256i excess = {};
+    if constexpr (type == QueryType::QUERY_SUBSETS) {
+      excess = _mm256_subs_epu8(candidate, query);
+    } else if constexpr (type == QueryType::QUERY_SUPERSETS) {
+      excess = _mm256_subs_epu8(query, candidate);
+    } else {
+      excess = _mm256_xor_si256(query, candidate);
+    }
+    const bool zero = _mm256_testz_si256(excess, excess);
+    out[i] = type == QueryType::QUERY_INEQUALITY ? !zero : zero;
+  }
+}
+
+WSR_TARGET_AVX2 void matchAvx2(
+    const wsr::detail::LetterCounts &letters,
+    std::span<const wsr::detail::LetterCounts> candidates,
+    wsr::detail::QueryType type,
+    std::span<std::uint8_t> out
+) noexcept {
+  using wsr::detail::QueryType;
+  switch (type) {
+    case QueryType::QUERY_SUBSETS:
+      return matchAvx2Impl<QueryType::QUERY_SUBSETS>(letters, candidates, out);
+    case QueryType::QUERY_SUPERSETS:
+      return matchAvx2Impl<QueryType::QUERY_SUPERSETS>(letters, candidates, out);
+    case QueryType::QUERY_EQUALITY:
+      return matchAvx2Impl<QueryType::QUERY_EQUALITY>(letters, candidates, out);
+    case QueryType::QUERY_INEQUALITY:
+      return matchAvx2Impl<QueryType::QUERY_INEQUALITY>(letters, candidates, out);
+  }
+}
+
 }  // namespace
 
 namespace wsr::detail {
 
+Signature::Signature(const LetterCounts &counts) noexcept {
+  for (std::size_t i = 0; i < alphaCount; ++i) {
+    full_[i] = counts[i];
+    partial_ |= std::uint32_t(counts[i] > 0) << i;
+  }
+}
+
 Signature::Signature(std::string_view string) {
   WSR_EXCEPTMSG(invalidCharErrMsg) = "Non-alphabetic character in input string.";
   for (std::size_t i = 0; i < string.size(); ++i) {
@@ -135,219 +623,1353 @@ bool Signature::operator<(const Signature &rhs) const noexcept {
   return rhs > *this;
 }
 
-void Database::sortFields_() {
-  std::sort(dictionaryEntries_.begin(), dictionaryEntries_.end(), [](const auto &a, const auto &b) {
-    const std::size_t sizeA = a.view.size();
-    const std::size_t sizeB = b.view.size();
-    if (sizeA != sizeB) {
-      return sizeA < sizeB;
-    }
-    return a.frequency > b.frequency;
-  });
+std::uint32_t Signature::mask() const noexcept {
+  return partial_;
 }
 
-void Database::parseDictionaryData_() {
-  WSR_EXCEPTMSG(parseFailErrMsg) = "Failed to parse text file.";
-  WSR_LOGMSG(parseDictStart) = "Constructing database dictionary data...";
-  WSR_PROFILE_SCOPE();
-  constexpr std::size_t expectedLineCount = 333333;
-  dictionaryEntries_.reserve(expectedLineCount);
+LetterCounts Signature::counts() const noexcept {
+  LetterCounts counts = {};
+  std::copy(full_.begin(), full_.end(), counts.begin());
+  return counts;
+}
 
-  utils::logMessage(utils::LogSeverity::LOG_INFO, parseDictStart);
-  for (std::size_t i = 0; i < dictionaryData_.size();) {
-    const std::size_t wordEnd = dictionaryData_.find_first_of('\t', i);
-    const std::size_t numEnd = dictionaryData_.find_first_of('\n', wordEnd + 1);
-    const char *pNStart = std::to_address(dictionaryData_.begin() + wordEnd + 1);
-    const char *pNEnd = std::to_address(dictionaryData_.begin() + numEnd);
-    std::size_t frequency = {};
-    const auto fchr = std::from_chars(pNStart, pNEnd, frequency);
-    utils::runtimeRequire(fchr.ptr == pNEnd, WSR_EXCEPTION(parseFailErrMsg));
+void matchSignatures(
+    const LetterCounts &letters,
+    std::span<const LetterCounts> candidates,
+    QueryType type,
+    std::span<std::uint8_t> out
+) noexcept {
+  WSR_ASSERT(candidates.size() <= out.size());
+  static const MatchKernel kernel = utils::cpuSupportsAvx2() ? matchAvx2 : matchScalar;
+  kernel(letters, candidates, type, out);
+}
 
-    const std::string_view view = {dictionaryData_.begin() + i, dictionaryData_.begin() + wordEnd};
-    dictionaryEntries_.emplace_back(Signature(view), view, frequency);
-    i = numEnd + 1;
+DictionaryMatches::DictionaryMatches(
+    std::span<const LetterCounts> candidates, const LetterCounts &letters, QueryType type
+) noexcept : candidates_(candidates), letters_(letters), type_(type) {
+  matchBatch_();
+  seek_();
+}
+
+void DictionaryMatches::matchBatch_() noexcept {
+  if (batchBegin_ < candidates_.size()) {
+    const std::size_t count = std::min(batchSize, candidates_.size() - batchBegin_);
+    matchSignatures(letters_, candidates_.subspan(batchBegin_, count), type_, matches_);
   }
 }
 
-void Database::parseLevelData_() {
-  WSR_EXCEPTMSG(parseFailErrMsg) = "Failed to parse text file.";
+void DictionaryMatches::seek_() noexcept {
+  while (batchBegin_ < candidates_.size()) {
+    const std::size_t count = std::min(batchSize, candidates_.size() - batchBegin_);
+    for (; position_ < count; ++position_) {
+      if (matches_[position_]) {
+        return;
+      }
+    }
+    batchBegin_ += batchSize;
+    position_ = 0;
+    matchBatch_();
+  }
+}
+
+std::vector<std::byte> Database::compile(
+    const fs::path &dataDirectory, std::size_t threadCount
+) {
+  WSR_EXCEPTMSG(layoutErrMsg) = "Invalid level layout.";
+  WSR_EXCEPTMSG(wordErrMsg) = "Dictionary word is too long.";
+  WSR_LOGMSG(compileStart) = "Compiling database snapshot from text sources...";
+  WSR_LOGMSG(parseDictStart) = "Constructing database dictionary data...";
   WSR_LOGMSG(parseLevelStart) = "Constructing database level data...";
   WSR_PROFILE_SCOPE();
-  constexpr std::size_t expectedLevelCount = 6000;
-  levelEntriesMap_.reserve(expectedLevelCount);
-  utils::logMessage(utils::LogSeverity::LOG_INFO, parseLevelStart);
-
-  for (std::size_t i = 0; i < levelData_.size();) {
-    const std::size_t widthEnd = levelData_.find_first_of(' ', i);
-    const std::size_t heightEnd = levelData_.find_first_of(' ', widthEnd + 1);
+  utils::logMessage(utils::LogSeverity::LOG_INFO, compileStart);
 
-    std::size_t width = {};
-    std::size_t height = {};
+  const fs::path dictionaryFilePath = dataDirectory / "words.txt";
+  const fs::path levelEntriesFilePath = dataDirectory / "data.txt";
+  const std::string dictionaryData = readTextFile(dictionaryFilePath);
+  const std::string levelData = readTextFile(levelEntriesFilePath);
 
-    const char *wStart = std::to_address(levelData_.begin() + i);
-    const char *wEnd = std::to_address(levelData_.begin() + widthEnd);
-    const char *hStart = std::to_address(levelData_.begin() + widthEnd + 1);
-    const char *hEnd = std::to_address(levelData_.begin() + heightEnd);
-    const auto wFchr = std::from_chars(wStart, wEnd, width);
-    const auto hFchr = std::from_chars(hStart, hEnd, height);
+  utils::ThreadPool pool(threadCount);
+  utils::logMessage(utils::LogSeverity::LOG_INFO, parseDictStart);
+  std::vector<DictionarySource> dictionary = parseChunked(pool, dictionaryData, parseDictionaryData);
+  utils::logMessage(utils::LogSeverity::LOG_INFO, parseLevelStart);
+  const std::vector<LevelSource> levelSources = parseChunked(pool, levelData, parseLevelData);
+  sortDictionary(pool, dictionary);
 
-    utils::runtimeRequire(wFchr.ptr == wEnd, WSR_EXCEPTION(parseFailErrMsg));
-    utils::runtimeRequire(hFchr.ptr == hEnd, WSR_EXCEPTION(parseFailErrMsg));
-
-    const auto iterLayoutBegin = levelData_.begin() + heightEnd + 1;
-    const auto iterLayoutEnd = iterLayoutBegin + width * height;
-    const std::string_view layout = {iterLayoutBegin, iterLayoutEnd};
-
-    const std::size_t wordsBegin = heightEnd + 1 + width * height + 1;  // + 1 to skip \t.
-    const std::size_t wordsEnd = [this, &wordsBegin] {
-      const std::size_t nline = levelData_.find_first_of('\n', wordsBegin);
-      return nline != levelData_.npos ? nline : levelData_.size();
-    }();
-    const wsr::Matrix<char> matrix = getLayoutMatrix(width, height, layout);
-    const std::vector<std::string_view> words = getWords(levelData_, wordsBegin, wordsEnd);
-    const std::size_t hash = hashLayout(layout);
-    levelEntriesMap_[hash] = {matrix, words};
-    i = wordsEnd + 1;
+  std::string levelText = {};
+  std::vector<LevelRecord> levels = {};
+  std::vector<PoolRef> levelWords = {};
+  levelText.reserve(levelData.size());
+  levels.reserve(levelSources.size());
+  for (const auto &source : levelSources) {
+    LevelRecord record = {};
+    record.layout = appendToPool(levelText, source.layout);
+    record.wordsBegin = std::uint32_t(levelWords.size());
+    record.width = std::uint8_t(source.width);
+    record.height = std::uint8_t(source.height);
+    for (const auto word : getWords(source.words)) {
+      levelWords.push_back(appendToPool(levelText, word));
+    }
+    record.wordCount = std::uint16_t(levelWords.size() - record.wordsBegin);
+    levels.push_back(record);
   }
-}
 
-Database::Database() {
-  WSR_EXCEPTMSG(constructFailErrMsg) = "Database construction failed.";
-  WSR_LOGMSG(constructStart) = "Constructing database.";
-  WSR_PROFILE_SCOPE();
+  // Levels are grouped by exact layout and the groups are placed by a perfect hash.
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> levelHashes = {};
+  std::vector<LayoutKey> levelKeys = {};
+  levelHashes.reserve(levelSources.size());
+  levelKeys.reserve(levelSources.size());
+  for (const auto &source : levelSources) {
+    const auto key = LayoutKey::fromString(source.width, source.height, source.layout);
+    utils::runtimeRequire(key.has_value(), WSR_EXCEPTION(layoutErrMsg));
+    levelHashes.emplace_back(key->hash(), std::uint32_t(levelKeys.size()));
+    levelKeys.push_back(*key);
+  }
+  std::sort(levelHashes.begin(), levelHashes.end());
 
-  utils::logMessage(utils::LogSeverity::LOG_INFO, constructStart);
-  try {
-    const fs::path root = utils::getRoot();
-    const fs::path dictionaryFilePath = root / "data" / "words.txt";
-    const fs::path levelEntriesFilePath = root / "data" / "data.txt";
-
-    std::ifstream dictionaryStream = {};
-    std::ifstream levelEntriesStream = {};
-
-    // ifstream::failbit not set to avoid issues regarding translation.
-    levelEntriesStream.exceptions(std::ifstream::badbit);
-    dictionaryStream.exceptions(std::ifstream::badbit);
-
-    levelEntriesStream.open(levelEntriesFilePath);
-    dictionaryStream.open(dictionaryFilePath);
-
-    const std::size_t dictionaryFileSize = fs::file_size(dictionaryFilePath);
-    const std::size_t levelEntriesFileSize = fs::file_size(levelEntriesFilePath);
-    dictionaryData_.resize(dictionaryFileSize);  // Zero-initialized.
-    levelData_.resize(levelEntriesFileSize);     // Zero-initialized.
-
-    dictionaryStream.read(dictionaryData_.data(), dictionaryFileSize);
-    levelEntriesStream.read(levelData_.data(), levelEntriesFileSize);
-
-    // Filesize is greater than true length due to byte->text \r\n translation.
-    const std::size_t tEndDictionaryData = std::strlen(dictionaryData_.data());
-    const std::size_t tEndLevelData = std::strlen(levelData_.data());
-    dictionaryData_.resize(tEndDictionaryData);
-    levelData_.resize(tEndLevelData);
-    dictionaryData_.shrink_to_fit();
-    levelData_.shrink_to_fit();
-
-    parseDictionaryData_();
-    parseLevelData_();
-    sortFields_();
-  } catch (...) {
-    utils::logMessage(utils::LogSeverity::LOG_CRITICAL, constructFailErrMsg);
-    throw;
+  std::vector<std::uint64_t> groupHashes = {};
+  std::vector<std::pair<std::size_t, std::size_t>> groupRanges = {};
+  for (std::size_t i = 0; i < levelHashes.size();) {
+    std::size_t end = i + 1;
+    while (end < levelHashes.size() && levelHashes[end].first == levelHashes[i].first) {
+      const bool sameKey = levelKeys[levelHashes[end].second] == levelKeys[levelHashes[i].second];
+      utils::runtimeRequire(sameKey, WSR_EXCEPTION(layoutErrMsg));
+      ++end;
+    }
+    groupHashes.push_back(levelHashes[i].first);
+    groupRanges.emplace_back(i, end);
+    i = end;
   }
-}
+  const auto [layoutParams, layoutPilots] = PerfectHash::build(groupHashes);
+  const PerfectHash layoutHash(layoutParams, layoutPilots);
 
-std::optional<LevelData> Database::query(const Matrix<char> &grid, std::string_view letters) const {
-  WSR_PROFILE_SCOPE();
-  const std::string_view gridData = {grid.data().data(), grid.sizeX() * grid.sizeY()};
-  const std::size_t levelHash = hashLayout(gridData);
-  const auto iter = levelEntriesMap_.find(levelHash);
-  if (iter == levelEntriesMap_.end()) {
-    return std::nullopt;
+  std::vector<LayoutGroup> layoutGroups(groupHashes.size());
+  std::vector<std::uint32_t> layoutMembers = {};
+  std::vector<std::size_t> groupAtSlot(groupHashes.size());
+  layoutMembers.reserve(levelHashes.size());
+  for (std::size_t group = 0; group < groupHashes.size(); ++group) {
+    groupAtSlot[layoutHash(groupHashes[group])] = group;
   }
-  const std::vector<std::string_view> &words = iter->second.words;
-  const std::string_view longestEntry = *std::max_element( // Wordscapes' longest word uses all the available letters.
-      words.begin(), words.end(), [](auto a, auto b) { return a.size() < b.size(); }
-  );
-  if (Signature(letters) != Signature(longestEntry)) {
-    return std::nullopt;
+  for (std::size_t slot = 0; slot < groupAtSlot.size(); ++slot) {
+    const auto [begin, end] = groupRanges[groupAtSlot[slot]];
+    LayoutGroup &group = layoutGroups[slot];
+    group.key = levelKeys[levelHashes[begin].second];
+    group.levelsBegin = std::uint32_t(layoutMembers.size());
+    group.levelCount = std::uint32_t(end - begin);
+    for (std::size_t i = begin; i < end; ++i) {
+      layoutMembers.push_back(levelHashes[i].second);
+    }
   }
-  return iter->second;
-}
 
-std::vector<DictionaryEntry> Database::query(std::string_view letters, QueryType type) const {
-  WSR_PROFILE_SCOPE();
-  const auto comparator = [type](const Signature &a, const Signature &b) {
-    switch (type) {
-      case QueryType::QUERY_SUBSETS:
-        return a >= b;
-      case QueryType::QUERY_SUPERSETS:
-        return a <= b;
-      case QueryType::QUERY_EQUALITY:
-        return a == b;
-      case QueryType::QUERY_INEQUALITY:
-        return a != b;
-    }
-  };
-  std::vector<DictionaryEntry> queryResult = {};
-  const auto letterSig = Signature(letters);
-  for (const auto &entry : dictionaryEntries_) {
-    if (comparator(letterSig, entry.signature)) {
-      queryResult.emplace_back(entry);
+  // Slots and crossings of every stored layout, so solving never analyzes them again.
+  std::vector<Slot> layoutSlots = {};
+  std::vector<std::uint32_t> slotCrossings = {0U};
+  std::vector<Crossing> layoutCrossings = {};
+  for (auto &group : layoutGroups) {
+    const LayoutStructure structure = analyzeLayout(group.key);
+    group.slotsBegin = std::uint32_t(layoutSlots.size());
+    group.slotCount = std::uint32_t(structure.slots.size());
+    layoutSlots.insert(layoutSlots.end(), structure.slots.begin(), structure.slots.end());
+    for (std::size_t s = 0; s < structure.slots.size(); ++s) {
+      slotCrossings.push_back(std::uint32_t(layoutCrossings.size()) + structure.crossingsBegin[s + 1]);
     }
+    layoutCrossings.insert(layoutCrossings.end(), structure.crossings.begin(), structure.crossings.end());
   }
-  return queryResult;
-}
 
-}  // namespace wsr::detail
+  // Every level's occupancy, grouped by dimensions for nearest-layout scans.
+  std::vector<std::uint32_t> byDimensions(levels.size());
+  std::iota(byDimensions.begin(), byDimensions.end(), 0U);
+  std::stable_sort(byDimensions.begin(), byDimensions.end(), [&levels](auto a, auto b) {
+    return std::pair(levels[a].width, levels[a].height) <
+           std::pair(levels[b].width, levels[b].height);
+  });
+  std::vector<DimensionBucket> dimensions = {};
+  std::vector<LayoutBits> occupancy = {};
+  std::vector<std::uint32_t> occupancyLevels = {};
+  occupancy.reserve(levels.size());
+  occupancyLevels.reserve(levels.size());
+  for (const auto level : byDimensions) {
+    const LevelRecord &record = levels[level];
+    if (dimensions.empty() || dimensions.back().width != record.width ||
+        dimensions.back().height != record.height) {
+      dimensions.emplace_back(record.width, record.height, std::uint32_t(occupancy.size()), 0U);
+    }
+    ++dimensions.back().count;
+    occupancy.push_back(levelKeys[level].bits);
+    occupancyLevels.push_back(level);
+  }
 
-namespace wsr {
+  // Wordscapes' longest word uses all the available letters.
+  std::vector<Signature> levelSignatures = {};
+  levelSignatures.reserve(levels.size());
+  for (const auto &record : levels) {
+    const auto words = std::span(levelWords).subspan(record.wordsBegin, record.wordCount);
+    const auto longest = std::max_element(words.begin(), words.end(), [](auto a, auto b) {
+      return a.size < b.size;
+    });
+    utils::runtimeRequire(longest != words.end(), WSR_EXCEPTION(layoutErrMsg));
+    levelSignatures.emplace_back(std::string_view(levelText).substr(longest->offset, longest->size));
+  }
 
-std::vector<std::string_view> Solver::fallbackDictionarySolve_(
-    const Matrix<char> &grid, std::string_view letters
-) const {
-  WSR_PROFILE_SCOPE();
-  std::ignore = grid;
-  /**
-   * TODO: Implementation.
-   * NOTE:
-   * This is a placeholder implementation.
-   * The actual dictionary solver will use information from the grid to constrain
-   * the possible answers from the query result as much as possible.
-   */
-  const auto queryResult = database_.query(letters, detail::QueryType::QUERY_SUBSETS);
-  std::vector<std::string_view> words = {};
-  words.reserve(queryResult.size());
-  std::transform(
-      queryResult.begin(), queryResult.end(), std::back_inserter(words), [](const auto &a) {
-        return a.view;
+  // Signatures are independent per entry and computed on the pool.
+  std::vector<Signature> signatures(dictionary.size());
+  std::vector<std::future<void>> signatureFutures = {};
+  const std::size_t signatureChunk = dictionary.size() / pool.size() + 1;
+  for (std::size_t begin = 0; begin < dictionary.size(); begin += signatureChunk) {
+    const std::size_t end = std::min(begin + signatureChunk, dictionary.size());
+    signatureFutures.push_back(pool.submit([&dictionary, &signatures, begin, end] {
+      for (std::size_t i = begin; i < end; ++i) {
+        signatures[i] = Signature(dictionary[i].view);
       }
-  );
-  return words;
-}
+    }));
+  }
 
-std::vector<std::string_view> Solver::querySolve_(
-    const Matrix<char> &grid, std::string_view letters
-) const {
-  WSR_PROFILE_SCOPE();
-  const std::optional<detail::LevelData> level = database_.query(grid, letters);
-  if (level.has_value()) {
-    return level->words;
+  std::string wordText = {};
+  std::vector<WordRecord> words = {};
+  wordText.reserve(dictionaryData.size());
+  words.reserve(dictionary.size());
+  for (const auto &entry : dictionary) {
+    utils::runtimeRequire(entry.view.size() <= UINT8_MAX, WSR_EXCEPTION(wordErrMsg));
+    const PoolRef text = appendToPool(wordText, entry.view);
+    words.emplace_back(
+        text.offset, std::uint8_t(text.size), 0U, WordRecord::quantizeFrequency(entry.frequency)
+    );
+  }
+  for (auto &future : signatureFutures) {
+    future.get();
+  }
+  // The word graph numbers words by case-insensitive lexicographic rank.
+  const auto wordLess = [&dictionary](std::uint32_t a, std::uint32_t b) {
+    const std::string_view lhs = dictionary[a].view;
+    const std::string_view rhs = dictionary[b].view;
+    return std::lexicographical_compare(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char x, char y) {
+          return (x & ~0x20) < (y & ~0x20);
+        }
+    );
+  };
+  std::vector<std::uint32_t> dawgWords(dictionary.size());
+  std::iota(dawgWords.begin(), dawgWords.end(), 0U);
+  std::stable_sort(dawgWords.begin(), dawgWords.end(), wordLess);
+  // Duplicate words keep their first, most frequent entry.
+  const auto duplicates = std::ranges::unique(dawgWords, [&wordLess](std::uint32_t a, std::uint32_t b) {
+    return !wordLess(a, b);
+  });
+  dawgWords.erase(duplicates.begin(), duplicates.end());
+  std::vector<std::string_view> dawgViews = {};
+  dawgViews.reserve(dawgWords.size());
+  for (const auto id : dawgWords) {
+    dawgViews.push_back(dictionary[id].view);
+  }
+  const auto [dawgNodes, dawgEdges] = Dawg::build(dawgViews);
+  utils::logMessage(
+      utils::LogSeverity::LOG_INFO,
+      std::format(
+          "Dictionary word graph: {} nodes, {} edges, {} KiB.",
+          dawgNodes.size(),
+          dawgEdges.size(),
+          (dawgNodes.size() * sizeof(DawgNode) + dawgEdges.size() * sizeof(DawgEdge)) / 1024
+      )
+  );
+
+  std::vector<LetterCounts> letterCounts = {};
+  letterCounts.reserve(signatures.size());
+  for (const auto &signature : signatures) {
+    letterCounts.push_back(signature.counts());
+  }
+
+  // Words are sorted by length, so each length is a contiguous id range.
+  std::vector<std::uint32_t> wordLengths = {0U};
+  for (std::size_t i = 0; i < words.size(); ++i) {
+    while (wordLengths.size() <= words[i].length) {
+      wordLengths.push_back(std::uint32_t(i));
+    }
+  }
+  wordLengths.push_back(std::uint32_t(words.size()));
+
+  // Word ids grouped by length, then by distinct letters. A stable sort keeps
+  // each bucket in dictionary order, so bucket scans need no further sorting.
+  std::vector<std::uint32_t> maskWords(words.size());
+  std::iota(maskWords.begin(), maskWords.end(), 0U);
+  std::stable_sort(maskWords.begin(), maskWords.end(), [&](std::uint32_t a, std::uint32_t b) {
+    return std::pair(words[a].length, signatures[a].mask()) <
+           std::pair(words[b].length, signatures[b].mask());
+  });
+  std::vector<MaskBucket> maskBuckets = {};
+  std::vector<std::uint32_t> maskLengths = {0U};
+  std::size_t bucketLength = 0;
+  for (std::size_t i = 0; i < maskWords.size(); ++i) {
+    const std::size_t length = words[maskWords[i]].length;
+    const std::uint32_t mask = signatures[maskWords[i]].mask();
+    if (maskBuckets.empty() || length != bucketLength || mask != maskBuckets.back().mask) {
+      while (maskLengths.size() <= length) {
+        maskLengths.push_back(std::uint32_t(maskBuckets.size()));
+      }
+      maskBuckets.emplace_back(mask, std::uint32_t(i), 0U);
+      bucketLength = length;
+    }
+    ++maskBuckets.back().count;
+  }
+  maskLengths.push_back(std::uint32_t(maskBuckets.size()));
+
+  SnapshotBuilder builder = {};
+  builder.setSection<LevelRecord>(SnapshotSection::SECTION_LEVELS, levels);
+  builder.setSection<PoolRef>(SnapshotSection::SECTION_LEVEL_WORDS, levelWords);
+  builder.setSection<char>(SnapshotSection::SECTION_LEVEL_TEXT, levelText);
+  builder.setSection<Signature>(SnapshotSection::SECTION_LEVEL_SIGNATURES, levelSignatures);
+  builder.setSection<PerfectHashParams>(
+      SnapshotSection::SECTION_LAYOUT_PARAMS, std::span(&layoutParams, 1)
+  );
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_LAYOUT_PILOTS, layoutPilots);
+  builder.setSection<LayoutGroup>(SnapshotSection::SECTION_LAYOUT_GROUPS, layoutGroups);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_LAYOUT_MEMBERS, layoutMembers);
+  builder.setSection<Slot>(SnapshotSection::SECTION_LAYOUT_SLOTS, layoutSlots);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_SLOT_CROSSINGS, slotCrossings);
+  builder.setSection<Crossing>(SnapshotSection::SECTION_LAYOUT_CROSSINGS, layoutCrossings);
+  builder.setSection<DimensionBucket>(SnapshotSection::SECTION_DIMENSIONS, dimensions);
+  builder.setSection<LayoutBits>(SnapshotSection::SECTION_OCCUPANCY, occupancy);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_OCCUPANCY_LEVELS, occupancyLevels);
+  builder.setSection<WordRecord>(SnapshotSection::SECTION_WORDS, words);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_WORD_LENGTHS, wordLengths);
+  builder.setSection<char>(SnapshotSection::SECTION_WORD_TEXT, wordText);
+  builder.setSection<MaskBucket>(SnapshotSection::SECTION_MASK_BUCKETS, maskBuckets);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_MASK_LENGTHS, maskLengths);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_MASK_WORDS, maskWords);
+  builder.setSection<LetterCounts>(SnapshotSection::SECTION_LETTER_COUNTS, letterCounts);
+  builder.setSection<DawgNode>(SnapshotSection::SECTION_DAWG_NODES, dawgNodes);
+  builder.setSection<DawgEdge>(SnapshotSection::SECTION_DAWG_EDGES, dawgEdges);
+  builder.setSection<std::uint32_t>(SnapshotSection::SECTION_DAWG_WORDS, dawgWords);
+  return builder.build(stampFile(levelEntriesFilePath), stampFile(dictionaryFilePath));
+}
+
+void Database::bindSnapshot_() {
+  WSR_EXCEPTMSG(bindErrMsg) = "Snapshot sections are inconsistent.";
+  levels_ = snapshot_.section<LevelRecord>(SnapshotSection::SECTION_LEVELS);
+  levelWords_ = snapshot_.section<PoolRef>(SnapshotSection::SECTION_LEVEL_WORDS);
+  levelSignatures_ = snapshot_.section<Signature>(SnapshotSection::SECTION_LEVEL_SIGNATURES);
+  layoutGroups_ = snapshot_.section<LayoutGroup>(SnapshotSection::SECTION_LAYOUT_GROUPS);
+  layoutMembers_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_LAYOUT_MEMBERS);
+  layoutSlots_ = snapshot_.section<Slot>(SnapshotSection::SECTION_LAYOUT_SLOTS);
+  slotCrossings_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_SLOT_CROSSINGS);
+  layoutCrossings_ = snapshot_.section<Crossing>(SnapshotSection::SECTION_LAYOUT_CROSSINGS);
+  dimensions_ = snapshot_.section<DimensionBucket>(SnapshotSection::SECTION_DIMENSIONS);
+  occupancy_ = snapshot_.section<LayoutBits>(SnapshotSection::SECTION_OCCUPANCY);
+  occupancyLevels_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_OCCUPANCY_LEVELS);
+  words_ = snapshot_.section<WordRecord>(SnapshotSection::SECTION_WORDS);
+  wordLengths_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_WORD_LENGTHS);
+  maskBuckets_ = snapshot_.section<MaskBucket>(SnapshotSection::SECTION_MASK_BUCKETS);
+  maskLengths_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_MASK_LENGTHS);
+  maskWords_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_MASK_WORDS);
+  letterCounts_ = snapshot_.section<LetterCounts>(SnapshotSection::SECTION_LETTER_COUNTS);
+  dawgWords_ = snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_DAWG_WORDS);
+
+  const auto levelText = snapshot_.section<char>(SnapshotSection::SECTION_LEVEL_TEXT);
+  const auto wordText = snapshot_.section<char>(SnapshotSection::SECTION_WORD_TEXT);
+  levelText_ = {levelText.data(), levelText.size()};
+  wordText_ = {wordText.data(), wordText.size()};
+  utils::runtimeRequire(levels_.size() == levelSignatures_.size(), WSR_EXCEPTION(bindErrMsg));
+  utils::runtimeRequire(occupancy_.size() == occupancyLevels_.size(), WSR_EXCEPTION(bindErrMsg));
+  utils::runtimeRequire(maskWords_.size() == words_.size(), WSR_EXCEPTION(bindErrMsg));
+  utils::runtimeRequire(
+      wordLengths_.size() >= 2 && wordLengths_.back() == words_.size(), WSR_EXCEPTION(bindErrMsg)
+  );
+  utils::runtimeRequire(letterCounts_.size() == words_.size(), WSR_EXCEPTION(bindErrMsg));
+  utils::runtimeRequire(
+      slotCrossings_.size() == layoutSlots_.size() + 1 &&
+          slotCrossings_.back() == layoutCrossings_.size(),
+      WSR_EXCEPTION(bindErrMsg)
+  );
+  utils::runtimeRequire(
+      !maskLengths_.empty() && maskLengths_.back() == maskBuckets_.size(), WSR_EXCEPTION(bindErrMsg)
+  );
+
+  const auto layoutParams = snapshot_.section<PerfectHashParams>(
+      SnapshotSection::SECTION_LAYOUT_PARAMS
+  );
+  utils::runtimeRequire(layoutParams.size() == 1, WSR_EXCEPTION(bindErrMsg));
+  layoutHash_ = PerfectHash(
+      layoutParams.front(), snapshot_.section<std::uint32_t>(SnapshotSection::SECTION_LAYOUT_PILOTS)
+  );
+  utils::runtimeRequire(layoutHash_.size() == layoutGroups_.size(), WSR_EXCEPTION(bindErrMsg));
+
+  dawg_ = Dawg(
+      snapshot_.section<DawgNode>(SnapshotSection::SECTION_DAWG_NODES),
+      snapshot_.section<DawgEdge>(SnapshotSection::SECTION_DAWG_EDGES)
+  );
+  utils::runtimeRequire(dawg_.size() == dawgWords_.size(), WSR_EXCEPTION(bindErrMsg));
+}
+
+std::uint16_t WordRecord::quantizeFrequency(std::uint64_t frequency) noexcept {
+  const double level = std::round(std::log2(double(frequency) + 1.0) * 1024.0);
+  return std::uint16_t(std::min(level, double(UINT16_MAX)));
+}
+
+std::uint64_t WordRecord::dequantizeFrequency(std::uint16_t level) noexcept {
+  return std::uint64_t(std::round(std::exp2(double(level) / 1024.0) - 1.0));
+}
+
+std::string_view Database::word_(std::size_t id) const noexcept {
+  WSR_ASSERT(id < words_.size());
+  return wordText_.substr(words_[id].offset, words_[id].length);
+}
+
+Database::Database() : Database(utils::getRoot() / "data") {}
+
+Database::Database(const fs::path &dataDirectory) {
+  WSR_LOGMSG(constructFailErrMsg) = "Database construction failed.";
+  WSR_LOGMSG(constructStart) = "Constructing database.";
+  WSR_LOGMSG(snapshotStaleMsg) = "Snapshot is out of date. Falling back to text sources...";
+  WSR_LOGMSG(snapshotInvalidMsg) = "Snapshot cannot be used. Falling back to text sources...";
+  WSR_PROFILE_SCOPE();
+
+  utils::logMessage(utils::LogSeverity::LOG_INFO, constructStart);
+  try {
+    const fs::path snapshotFilePath = dataDirectory / snapshotFileName;
+    const fs::path dictionaryFilePath = dataDirectory / "words.txt";
+    const fs::path levelEntriesFilePath = dataDirectory / "data.txt";
+
+    if (fs::exists(snapshotFilePath)) {
+      try {
+        Snapshot snapshot = Snapshot(MappedFile(snapshotFilePath));
+        const SnapshotHeader &header = snapshot.header();
+
+        // Missing text sources mean the snapshot was deployed on its own.
+        const bool levelsFresh = !fs::exists(levelEntriesFilePath) ||
+                                 header.levelSource == stampFile(levelEntriesFilePath);
+        const bool dictionaryFresh = !fs::exists(dictionaryFilePath) ||
+                                     header.dictionarySource == stampFile(dictionaryFilePath);
+        if (levelsFresh && dictionaryFresh) {
+          snapshot_ = std::move(snapshot);
+        } else {
+          utils::logMessage(utils::LogSeverity::LOG_ERROR, snapshotStaleMsg);
+        }
+      } catch (const std::exception &) {
+        utils::logMessage(utils::LogSeverity::LOG_ERROR, snapshotInvalidMsg);
+      }
+    }
+    if (snapshot_.size() == 0) {
+      snapshot_ = Snapshot(compile(dataDirectory));
+    }
+    bindSnapshot_();
+    utils::logMessage(
+        utils::LogSeverity::LOG_INFO,
+        std::format(
+            "Database ready: {} levels, {} words, {} KiB.",
+            levels_.size(),
+            words_.size(),
+            snapshot_.size() / 1024
+        )
+    );
+    // Compared against holding every word as a DictionaryEntry over its text.
+    const std::size_t dictionaryBytes =
+        words_.size_bytes() + letterCounts_.size_bytes() + wordText_.size();
+    const std::size_t entryBytes = words_.size() * sizeof(DictionaryEntry) + wordText_.size();
+    utils::logMessage(
+        utils::LogSeverity::LOG_INFO,
+        std::format(
+            "Dictionary records: {} KiB, down from {} KiB as entries.",
+            dictionaryBytes / 1024,
+            entryBytes / 1024
+        )
+    );
+  } catch (...) {
+    utils::logMessage(utils::LogSeverity::LOG_CRITICAL, constructFailErrMsg);
+    throw;
+  }
+}
+
+LevelView Database::levelView_(std::size_t level) const noexcept {
+  WSR_ASSERT(level < levels_.size());
+  const LevelRecord &record = levels_[level];
+  return {
+      std::uint32_t(level),
+      record.width,
+      record.height,
+      levelText_.substr(record.layout.offset, record.layout.size),
+      levelWords_.subspan(record.wordsBegin, record.wordCount),
+      levelText_
+  };
+}
+
+LevelData Database::levelData_(std::size_t level) const {
+  const LevelView view = levelView_(level);
+  std::vector<std::string_view> words = {};
+  words.reserve(view.words.size());
+  for (std::size_t i = 0; i < view.words.size(); ++i) {
+    words.push_back(view.word(i));
+  }
+  return {getLayoutMatrix(view.width, view.height, view.layout), std::move(words)};
+}
+
+std::span<const std::uint32_t> Database::exactLayoutLevels_(const Matrix<char> &grid) const noexcept {
+  const std::optional<LayoutKey> key = LayoutKey::fromGrid(grid);
+  if (!key.has_value() || layoutGroups_.empty()) {
+    return {};
+  }
+  const LayoutGroup &group = layoutGroups_[layoutHash_(key->hash())];
+  if (group.key != *key) {
+    return {};
+  }
+  return layoutMembers_.subspan(group.levelsBegin, group.levelCount);
+}
+
+std::span<const std::size_t> Database::placeLevel_(
+    std::size_t level, std::span<const Slot> slots, const Matrix<char> &grid
+) const {
+  // Kept per thread, so placing levels on revealed boards stops allocating.
+  thread_local Placement placement = {};
+  const LevelView view = levelView_(level);
+  placement.words.clear();
+  for (std::size_t i = 0; i < view.words.size(); ++i) {
+    placement.words.push_back(view.word(i));
+  }
+  if (!placeWords(slots, placement.words, grid, placement)) {
+    return {};
+  }
+  return placement.assignment;
+}
+
+std::optional<LevelData> Database::resolveLevel_(std::size_t level, const Matrix<char> &grid) const {
+  LevelData data = levelData_(level);
+  const LevelRecord &record = levels_[level];
+  const std::string_view layout = levelText_.substr(record.layout.offset, record.layout.size);
+  const std::optional<LayoutKey> key = LayoutKey::fromString(record.width, record.height, layout);
+  WSR_ASSERT(key.has_value());
+  WSR_ASSERT(grid.sizeX() == record.width && grid.sizeY() == record.height);
+
+  const auto revealed = std::ranges::any_of(grid.data(), isRevealed);
+  if (!revealed) {
+    data.unsolved = data.words;
+    return data;
+  }
+
+  const std::span<const Slot> slots = layoutAnalysis(*key).slots;
+  const std::span<const std::size_t> placement = placeLevel_(level, slots, grid);
+  if (placement.empty()) {
+    return std::nullopt;
+  }
+  std::vector<bool> solved(data.words.size());
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    solved[placement[s]] = isSlotRevealed(slots[s], grid);
+  }
+  for (std::size_t w = 0; w < data.words.size(); ++w) {
+    if (!solved[w]) {
+      data.unsolved.push_back(data.words[w]);
+    }
+  }
+  return data;
+}
+
+std::optional<LevelData> Database::query(const Matrix<char> &grid, std::string_view letters) const {
+  WSR_PROFILE_SCOPE();
+  const Signature letterSig = Signature(letters);
+  for (const auto level : exactLayoutLevels_(grid)) {
+    if (levelSignatures_[level] != letterSig) {
+      continue;
+    }
+    std::optional<LevelData> data = resolveLevel_(level, grid);
+    if (data.has_value()) {
+      return data;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<LevelView> Database::queryView(
+    const Matrix<char> &grid, std::string_view letters
+) const {
+  WSR_PROFILE_SCOPE();
+  const Signature letterSig = Signature(letters);
+  const auto revealed = std::ranges::any_of(grid.data(), isRevealed);
+  const std::span<const std::uint32_t> levels = exactLayoutLevels_(grid);
+  std::span<const Slot> slots = {};
+  if (revealed && !levels.empty()) {
+    slots = layoutAnalysis(*LayoutKey::fromGrid(grid)).slots;
+  }
+  for (const auto level : levels) {
+    if (levelSignatures_[level] != letterSig) {
+      continue;
+    }
+    // Only boards with revealed letters need a placement to tell levels apart.
+    if (!revealed || !placeLevel_(level, slots, grid).empty()) {
+      return levelView_(level);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<LevelData> Database::queryNearest(
+    const Matrix<char> &grid, std::string_view letters, std::size_t maxDistance
+) const {
+  WSR_PROFILE_SCOPE();
+  constexpr std::size_t batchSize = 256;
+  const std::optional<LayoutKey> key = LayoutKey::fromGrid(grid);
+  if (!key.has_value()) {
+    return std::nullopt;
+  }
+  const auto bucket = std::lower_bound(
+      dimensions_.begin(), dimensions_.end(), *key, [](const auto &a, const auto &b) {
+        return std::pair(a.width, a.height) < std::pair(b.width, b.height);
+      }
+  );
+  if (bucket == dimensions_.end() || bucket->width != key->width ||
+      bucket->height != key->height) {
+    return std::nullopt;
+  }
+
+  const Signature letterSig = Signature(letters);
+  const auto candidates = occupancy_.subspan(bucket->begin, bucket->count);
+  const auto candidateLevels = occupancyLevels_.subspan(bucket->begin, bucket->count);
+  std::array<std::uint16_t, batchSize> distances = {};
+  std::size_t bestDistance = maxDistance + 1;
+  std::size_t bestLevel = {};
+  for (std::size_t begin = 0; begin < candidates.size(); begin += batchSize) {
+    const std::size_t count = std::min(batchSize, candidates.size() - begin);
+    hammingDistances(key->bits, candidates.subspan(begin, count), distances);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (distances[i] >= bestDistance) {
+        continue;
+      }
+      const std::uint32_t level = candidateLevels[begin + i];
+      if (levelSignatures_[level] == letterSig) {
+        bestDistance = distances[i];
+        bestLevel = level;
+      }
+    }
+  }
+  if (bestDistance > maxDistance) {
+    return std::nullopt;
+  }
+
+  // Misread cells may also misplace revealed letters, so they are only used when consistent.
+  std::optional<LevelData> data = resolveLevel_(bestLevel, grid);
+  if (!data.has_value()) {
+    data = levelData_(bestLevel);
+    data->unsolved = data->words;
+  }
+  return data;
+}
+
+bool Database::queryIndexed_(
+    const Signature &letterSig,
+    std::size_t letterCount,
+    QueryType type,
+    std::vector<std::uint32_t> &ids
+) const {
+  // Beyond this many distinct letters, enumerating submasks costs more than a scan.
+  constexpr int maxIndexedLetters = 12;
+  const std::uint32_t letterMask = letterSig.mask();
+  if (std::popcount(letterMask) > maxIndexedLetters) {
+    return false;
+  }
+
+  const auto lengthBuckets = [this](std::size_t length) -> std::span<const MaskBucket> {
+    if (length + 1 >= maskLengths_.size()) {
+      return {};
+    }
+    return maskBuckets_.subspan(maskLengths_[length], maskLengths_[length + 1] - maskLengths_[length]);
+  };
+  const auto findBucket = [](std::span<const MaskBucket> buckets, std::uint32_t mask) {
+    const auto it = std::lower_bound(buckets.begin(), buckets.end(), mask, [](const auto &a, auto b) {
+      return a.mask < b;
+    });
+    return it != buckets.end() && it->mask == mask ? &*it : nullptr;
+  };
+
+  const LetterCounts letterCounts = letterSig.counts();
+  const auto fitsLetters = [&letterCounts](const LetterCounts &counts) {
+    bool fits = true;
+    for (std::size_t c = 0; c < counts.size(); ++c) {
+      fits &= counts[c] <= letterCounts[c];
+    }
+    return fits;
+  };
+
+  switch (type) {
+    case QueryType::QUERY_SUBSETS:
+      for (std::size_t length = 1; length <= letterCount; ++length) {
+        const auto buckets = lengthBuckets(length);
+        if (buckets.empty()) {
+          continue;
+        }
+        const std::size_t first = ids.size();
+        for (std::uint32_t sub = letterMask;; sub = (sub - 1) & letterMask) {
+          const MaskBucket *bucket = std::size_t(std::popcount(sub)) <= length
+                                         ? findBucket(buckets, sub)
+                                         : nullptr;
+          if (bucket != nullptr) {
+            for (const auto id : maskWords_.subspan(bucket->begin, bucket->count)) {
+              if (fitsLetters(letterCounts_[id])) {
+                ids.push_back(id);
+              }
+            }
+          }
+          if (sub == 0) {
+            break;
+          }
+        }
+        // Buckets are visited by mask, so restore dictionary order within the length.
+        std::sort(ids.begin() + std::ptrdiff_t(first), ids.end());
+      }
+      return true;
+    case QueryType::QUERY_EQUALITY:
+      if (const MaskBucket *bucket = findBucket(lengthBuckets(letterCount), letterMask)) {
+        for (const auto id : maskWords_.subspan(bucket->begin, bucket->count)) {
+          if (letterCounts_[id] == letterCounts) {
+            ids.push_back(id);
+          }
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::vector<DictionaryEntry> Database::query(
+    std::string_view letters, QueryType type, QueryStrategy strategy
+) const {
+  WSR_PROFILE_SCOPE();
+  std::vector<std::uint32_t> ids = {};
+  queryIds(letters, type, ids, strategy);
+  std::vector<DictionaryEntry> queryResult = {};
+  queryResult.reserve(ids.size());
+  for (const auto id : ids) {
+    queryResult.push_back(entry(id));
+  }
+  return queryResult;
+}
+
+void Database::queryIds(
+    std::string_view letters, QueryType type, std::vector<std::uint32_t> &ids, QueryStrategy strategy
+) const {
+  WSR_PROFILE_SCOPE();
+  ids.clear();
+  const auto letterSig = Signature(letters);
+  if (strategy == QueryStrategy::STRATEGY_AUTO && queryIndexed_(letterSig, letters.size(), type, ids)) {
+    return;
+  }
+  for (const auto id : DictionaryMatches(letterCounts_, letterSig.counts(), type)) {
+    ids.push_back(id);
   }
-  return {};
 }
 
-std::vector<std::string_view> Solver::solve(const Matrix<char> &grid, std::string_view letters) {
+DictionaryMatches Database::matches(std::string_view letters, QueryType type) const {
+  return DictionaryMatches(letterCounts_, Signature(letters).counts(), type);
+}
+
+std::vector<DictionaryEntry> Database::generate(
+    std::string_view letters, const WordFilter &filter
+) const {
+  WSR_PROFILE_SCOPE();
+  std::vector<std::uint32_t> ids = {};
+  generateIds(letters, filter, ids);
+  std::vector<DictionaryEntry> queryResult = {};
+  queryResult.reserve(ids.size());
+  for (const auto id : ids) {
+    queryResult.push_back(entry(id));
+  }
+  return queryResult;
+}
+
+void Database::generateIds(
+    std::string_view letters, const WordFilter &filter, std::vector<std::uint32_t> &ids
+) const {
+  WSR_PROFILE_SCOPE();
+  std::ignore = Signature(letters);  // Rejects non-alphabetic letters like the other queries.
+  ids.clear();
+  dawg_.generate(letters, filter, ids);
+  for (auto &id : ids) {
+    id = dawgWords_[id];
+  }
+  std::sort(ids.begin(), ids.end(), [this](std::uint32_t a, std::uint32_t b) {
+    if (words_[a].frequency != words_[b].frequency) {
+      return words_[a].frequency > words_[b].frequency;
+    }
+    return a < b;
+  });
+}
+
+std::vector<DictionaryEntry> Database::queryTop(
+    std::string_view letters, QueryType type, std::size_t k, const WordFilter &filter
+) const {
+  WSR_PROFILE_SCOPE();
+  std::vector<std::uint32_t> ids = {};
+  queryTopIds(letters, type, k, filter, ids);
+  std::vector<DictionaryEntry> queryResult = {};
+  queryResult.reserve(ids.size());
+  for (const auto id : ids) {
+    queryResult.push_back(entry(id));
+  }
+  return queryResult;
+}
+
+void Database::queryTopIds(
+    std::string_view letters,
+    QueryType type,
+    std::size_t k,
+    const WordFilter &filter,
+    std::vector<std::uint32_t> &ids
+) const {
+  WSR_PROFILE_SCOPE();
+  ids.clear();
+  const LetterCounts letterCounts = Signature(letters).counts();
+  std::size_t minLength = std::max<std::size_t>(filter.minLength, 1);
+  std::size_t maxLength = std::min(filter.maxLength, wordLengths_.size() - 2);
+  if (!filter.pattern.empty()) {
+    minLength = std::max(minLength, filter.pattern.size());
+    maxLength = std::min(maxLength, filter.pattern.size());
+  }
+  if (type == QueryType::QUERY_SUBSETS) {
+    maxLength = std::min(maxLength, letters.size());
+  } else if (type == QueryType::QUERY_EQUALITY) {
+    minLength = std::max(minLength, letters.size());
+    maxLength = std::min(maxLength, letters.size());
+  }
+  if (k == 0) {
+    return;
+  }
+
+  for (std::size_t length = minLength; length <= maxLength; ++length) {
+    const std::uint32_t begin = wordLengths_[length];
+    const auto candidates = letterCounts_.subspan(begin, wordLengths_[length + 1] - begin);
+    std::size_t found = 0;
+    for (const auto offset : DictionaryMatches(candidates, letterCounts, type)) {
+      const std::uint32_t id = begin + offset;
+      if (!matchesPattern(word_(id), filter.pattern)) {
+        continue;
+      }
+      ids.push_back(id);
+      if (++found == k) {
+        break;
+      }
+    }
+  }
+}
+
+LayoutAnalysis Database::layoutAnalysis(const LayoutKey &key) const {
+  if (!layoutGroups_.empty()) {
+    const LayoutGroup &group = layoutGroups_[layoutHash_(key.hash())];
+    if (group.key == key) {
+      const auto crossingsBegin = slotCrossings_.subspan(group.slotsBegin, group.slotCount + 1);
+      return {
+          layoutSlots_.subspan(group.slotsBegin, group.slotCount),
+          layoutCrossings_.subspan(
+              crossingsBegin.front(), crossingsBegin.back() - crossingsBegin.front()
+          ),
+          crossingsBegin
+      };
+    }
+  }
+
+  // Any client can send new layouts, so an arbitrary one makes room once the memo is
+  // full. Analyses still in use stay alive through their owner.
+  std::lock_guard lock(layoutMemoMutex_);
+  auto it = layoutMemo_.find(key);
+  if (it == layoutMemo_.end()) {
+    if (layoutMemo_.size() >= layoutMemoCapacity) {
+      layoutMemo_.erase(layoutMemo_.begin());
+    }
+    auto analyzed = std::make_shared<const LayoutStructure>(analyzeLayout(key));
+    it = layoutMemo_.emplace(key, std::move(analyzed)).first;
+  }
+  LayoutAnalysis analysis = it->second->view();
+  analysis.owner = it->second;
+  return analysis;
+}
+
+DictionaryEntry Database::entry(std::size_t id) const noexcept {
+  WSR_ASSERT(id < words_.size());
+  return {
+      Signature(letterCounts_[id]),
+      word_(id),
+      WordRecord::dequantizeFrequency(words_[id].frequency)
+  };
+}
+
+}  // namespace wsr::detail
+
+namespace wsr {
+
+std::vector<std::string_view> Solver::fallbackDictionarySolve_(
+    const Matrix<char> &grid, std::string_view letters
+) const {
+  WSR_LOGMSG(logCrosswordFailed) = "Crossword search failed. Guessing the most frequent words...";
+  WSR_PROFILE_SCOPE();
+  constexpr std::size_t candidatesPerSlot = 4;
+  constexpr std::size_t quickSearchNodes = 2000;
+  std::vector<std::uint32_t> ids = {};
+  std::vector<std::string_view> words = {};
+  const auto key = detail::LayoutKey::fromGrid(grid);
+  if (!key.has_value()) {
+    database_.generateIds(letters, {}, ids);
+    for (const auto id : ids) {
+      words.push_back(database_.entry(id).view);
+    }
+    return words;
+  }
+
+  const detail::LayoutAnalysis layout = database_.layoutAnalysis(*key);
+  const std::span<const detail::Slot> slots = layout.slots;
+  words = slotCandidates(database_, layout, letters).words;
+
+  // Most layouts fill within a short search, so the portfolio only
+  // starts once that runs out of nodes.
+  const detail::Crossword crossword(layout, grid, words);
+  std::optional<std::vector<std::string_view>> fill = {};
+  if (searchPool_ == nullptr) {
+    fill = crossword.solve();
+  } else {
+    detail::SearchOptions quickSearch = {};
+    quickSearch.maxNodes = quickSearchNodes;
+    fill = crossword.solve(quickSearch);
+    if (!fill.has_value()) {
+      fill = crossword.solveParallel(*searchPool_);
+    }
+  }
+  if (fill.has_value()) {
+    words.clear();
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      if (!isSlotRevealed(slots[s], grid)) {
+        words.push_back((*fill)[s]);
+      }
+    }
+    return words;
+  }
+  utils::logMessage(utils::LogSeverity::LOG_INFO, logCrosswordFailed);
+
+  // Without a consistent fill, only the slot lengths of the grid are used,
+  // taking the most frequent few candidates of each length.
+  words.clear();
+  std::array<std::size_t, UINT8_MAX + 1> slotCounts = {};
+  for (const auto &slot : slots) {
+    ++slotCounts[slot.length];
+  }
+  for (std::size_t length = 0; length < slotCounts.size(); ++length) {
+    if (slotCounts[length] == 0) {
+      continue;
+    }
+    const detail::WordFilter filter = {length, length};
+    database_.queryTopIds(
+        letters, detail::QueryType::QUERY_SUBSETS, slotCounts[length] * candidatesPerSlot, filter, ids
+    );
+    for (const auto id : ids) {
+      words.push_back(database_.entry(id).view);
+    }
+  }
+  return words;
+}
+
+std::optional<std::vector<std::string_view>> Solver::querySolve_(
+    const Matrix<char> &grid, std::string_view letters
+) const {
+  WSR_LOGMSG(logQueryNearest) = "Exact layout not found. Matched the nearest stored layout...";
+  WSR_PROFILE_SCOPE();
+  if (!databaseLookup_) {
+    return std::nullopt;
+  }
+  std::optional<detail::LevelData> level = database_.query(grid, letters);
+  if (!level.has_value() && layoutTolerance_ > 0) {
+    level = database_.queryNearest(grid, letters, layoutTolerance_);
+    if (level.has_value()) {
+      utils::logMessage(utils::LogSeverity::LOG_INFO, logQueryNearest);
+    }
+  }
+  if (!level.has_value()) {
+    return std::nullopt;
+  }
+  if (level->unsolved.size() != level->words.size()) {
+    utils::logMessage(
+        utils::LogSeverity::LOG_INFO,
+        std::format("Resuming level: {} of {} words left.", level->unsolved.size(), level->words.size())
+    );
+  }
+  return std::move(level->unsolved);
+}
+
+PartialSolution Solver::anytimeSolve_(
+    const Matrix<char> &grid, std::string_view letters, std::chrono::steady_clock::time_point deadline
+) const {
+  WSR_PROFILE_SCOPE();
+  PartialSolution solution = {};
+  const auto key = detail::LayoutKey::fromGrid(grid);
+  if (!key.has_value()) {
+    return solution;
+  }
+  const detail::LayoutAnalysis layout = database_.layoutAnalysis(*key);
+  const SlotCandidates candidates = slotCandidates(database_, layout, letters);
+  const detail::Crossword crossword(layout, grid, candidates.words, candidates.frequencies);
+  detail::SearchOptions options = {};
+  options.deadline = deadline;
+  const detail::CrosswordFill fill = crossword.solveAnytime(options);
+
+  for (std::size_t s = 0; s < layout.slots.size(); ++s) {
+    if (fill.words[s].empty() || isSlotRevealed(layout.slots[s], grid)) {
+      continue;
+    }
+    solution.answers.push_back(rankAnswer(crossword, s, fill.words[s]));
+  }
+  std::stable_sort(solution.answers.begin(), solution.answers.end(), [](const auto &a, const auto &b) {
+    return a.confidence > b.confidence;
+  });
+  solution.complete = fill.complete;
+  return solution;
+}
+
+SolveSession::SolveSession(
+    const detail::Database &database, const Matrix<char> &grid, std::string_view letters
+)
+    : grid_(grid) {
+  WSR_PROFILE_SCOPE();
+  const auto key = detail::LayoutKey::fromGrid(grid);
+  if (!key.has_value()) {
+    return;
+  }
+  const detail::LayoutAnalysis layout = database.layoutAnalysis(*key);
+  const SlotCandidates candidates = slotCandidates(database, layout, letters);
+  crossword_.emplace(layout, grid, candidates.words, candidates.frequencies);
+  for (const auto &slot : layout.slots) {
+    solved_.push_back(isSlotRevealed(slot, grid));
+  }
+}
+
+bool SolveSession::isAccepted_(std::string_view word) const noexcept {
+  return std::ranges::any_of(accepted_, [word](std::string_view accepted) {
+    return utils::equalsIgnoreCase(accepted, word);
+  });
+}
+
+bool SolveSession::fillHolds_(const detail::CrosswordFill &fill) const {
+  for (std::size_t s = 0; s < fill.words.size(); ++s) {
+    if (!fill.words[s].empty() && !crossword_->hasCandidate(s, fill.words[s])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SolveSession::checkFill_() {
+  beliefs_.reset();
+  if (fill_.has_value() && !fillHolds_(*fill_)) {
+    fill_.reset();
+  }
+  std::erase_if(samples_, [this](const detail::CrosswordFill &fill) { return !fillHolds_(fill); });
+}
+
+void SolveSession::wordAccepted(std::string_view word) {
+  WSR_PROFILE_SCOPE();
+  accepted_.push_back(word);
+  if (!crossword_.has_value()) {
+    return;
+  }
+
+  // A word fitting a single unsolved slot is placed there. Otherwise the
+  // letters the game reveals next tell its slot apart.
+  std::size_t slot = solved_.size();
+  std::size_t fits = 0;
+  for (std::size_t s = 0; s < solved_.size(); ++s) {
+    if (!solved_[s] && crossword_->hasCandidate(s, word)) {
+      slot = s;
+      ++fits;
+    }
+  }
+  if (fits == 1) {
+    crossword_->assign(slot, word);
+    solved_[slot] = true;
+    checkFill_();
+  }
+}
+
+void SolveSession::wordRejected(std::string_view word) {
+  WSR_PROFILE_SCOPE();
+  if (!crossword_.has_value()) {
+    return;
+  }
+  crossword_->exclude(word);
+  checkFill_();
+}
+
+void SolveSession::cellRevealed(Point cell, char letter) {
+  WSR_PROFILE_SCOPE();
+  grid_[cell] = letter;
+  if (!crossword_.has_value()) {
+    return;
+  }
+  crossword_->reveal(cell, letter);
+  const auto slots = crossword_->slots();
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    solved_[s] = solved_[s] || isSlotRevealed(slots[s], grid_);
+  }
+  checkFill_();
+}
+
+double SolveSession::GuessBeliefs::crossingMass(
+    const detail::Crossing &crossing, std::string_view word
+) const noexcept {
+  return letterMass[massBegin[crossing.slot] + crossing.otherPosition * alphaCount +
+                    std::size_t((word[crossing.position] & ~0x20) - 'A')];
+}
+
+void SolveSession::updateBeliefs_() {
+  WSR_PROFILE_SCOPE();
+  if (beliefs_.has_value()) {
+    return;
+  }
+  const auto slots = crossword_->slots();
+  GuessBeliefs &beliefs = beliefs_.emplace();
+  auto &candidates = beliefs.candidates;
+  auto &probabilities = beliefs.probabilities;
+  auto &massBegin = beliefs.massBegin;
+
+  // Candidates start from their frequency prior, then are weighed by how likely
+  // the crossing slots are to show their letters at the crossings.
+  candidates.resize(slots.size());
+  probabilities.resize(slots.size());
+  massBegin.resize(slots.size() + 1);
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    crossword_->rankCandidates(s, candidates[s]);
+    for (const auto &candidate : candidates[s]) {
+      probabilities[s].push_back(candidate.probability);
+    }
+    massBegin[s + 1] = massBegin[s] + slots[s].length * GuessBeliefs::alphaCount;
+  }
+
+  beliefs.letterMass.resize(massBegin.back());
+  const auto updateMass = [&] {
+    std::ranges::fill(beliefs.letterMass, 0.0);
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      for (std::size_t i = 0; i < candidates[s].size(); ++i) {
+        const std::string_view word = candidates[s][i].word;
+        for (std::size_t position = 0; position < word.size(); ++position) {
+          const auto letter = std::size_t((word[position] & ~0x20) - 'A');
+          beliefs.letterMass[massBegin[s] + position * GuessBeliefs::alphaCount + letter] +=
+              probabilities[s][i];
+        }
+      }
+    }
+  };
+  updateMass();
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    double total = 0.0;
+    for (std::size_t i = 0; i < candidates[s].size(); ++i) {
+      for (const auto &crossing : crossword_->crossingsOf(s)) {
+        probabilities[s][i] *= beliefs.crossingMass(crossing, candidates[s][i].word);
+      }
+      total += probabilities[s][i];
+    }
+    for (auto &probability : probabilities[s]) {
+      probability = total > 0.0 ? probability / total : 0.0;
+    }
+  }
+  updateMass();
+}
+
+void SolveSession::updateSamples_() {
+  WSR_PROFILE_SCOPE();
+  constexpr std::size_t sampleCount = 16;
+  constexpr std::size_t sampleNodes = 2000;
+  while (samples_.size() < sampleCount) {
+    detail::SearchOptions options = {};
+    options.candidateOrder = detail::CandidateOrder::ORDER_RANDOM;
+    options.seed = nextSampleSeed_++;
+    options.maxNodes = sampleNodes;
+    samples_.push_back(crossword_->solveAnytime(options));
+  }
+}
+
+std::optional<RankedAnswer> SolveSession::expectedCostWord_() {
+  WSR_PROFILE_SCOPE();
+  // Share of the hit estimate taken from sampled fills rather than letter beliefs.
+  constexpr double sampleWeight = 0.5;
+
+  // How much the expected pruning of crossings counts against the chance of a hit.
+  // Hits come first: larger weights cost swipes on the data.txt replay.
+  constexpr double pruningWeight = 0.02;
+
+  updateBeliefs_();
+  updateSamples_();
+  const auto slots = crossword_->slots();
+  const GuessBeliefs &beliefs = *beliefs_;
+
+  // Arc consistency misses words that no whole fill can hold, so the share of
+  // shuffled fills holding each word estimates its chance as well.
+  std::unordered_map<std::string_view, double> sampled = {};
+  for (const auto &fill : samples_) {
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      if (!solved_[s] && !fill.words[s].empty()) {
+        sampled[fill.words[s]] += 1.0 / double(samples_.size());
+      }
+    }
+  }
+
+  struct Guess {
+    std::size_t slot = {};  // Where the word is likeliest.
+    double slotProbability = {};
+    double missProbability = 1.0;
+    double expectedPruning = {};
+  };
+  std::unordered_map<std::string_view, Guess> guesses = {};
+  for (std::size_t s = 0; s < slots.size(); ++s) {
+    if (solved_[s]) {
+      continue;
+    }
+    for (std::size_t i = 0; i < beliefs.candidates[s].size(); ++i) {
+      const std::string_view word = beliefs.candidates[s][i].word;
+      const double probability = beliefs.probabilities[s][i];
+      if (isAccepted_(word)) {
+        continue;
+      }
+      // Share of the open crossing slots' belief a hit would rule out.
+      double slotPruning = 0.0;
+      for (const auto &crossing : crossword_->crossingsOf(s)) {
+        slotPruning += solved_[crossing.slot] ? 0.0 : 1.0 - beliefs.crossingMass(crossing, word);
+      }
+      Guess &guess = guesses[word];
+      if (probability > guess.slotProbability) {
+        guess.slot = s;
+        guess.slotProbability = probability;
+      }
+      guess.missProbability *= 1.0 - probability;
+      guess.expectedPruning += probability * slotPruning;
+    }
+  }
+
+  // A guess costs one swipe whether or not it is an answer, so the chance of a
+  // hit comes first, and the crossings a hit would narrow break near ties.
+  // Equal scores go to the likelier slot, then the earlier slot, then the
+  // earlier word, so the pick never depends on the order of the hash map.
+  const auto tiedBefore = [](const Guess &a, std::string_view aWord, const Guess &b,
+                             std::string_view bWord) {
+    return std::tuple(-a.slotProbability, a.slot, aWord) <
+           std::tuple(-b.slotProbability, b.slot, bWord);
+  };
+  const Guess *bestGuess = nullptr;
+  std::string_view bestWord = {};
+  double bestScore = -1.0;
+  double bestHitProbability = 0.0;
+  for (const auto &[word, guess] : guesses) {
+    const auto sample = sampled.find(word);
+    const double sampledProbability = sample == sampled.end() ? 0.0 : sample->second;
+    const double hitProbability =
+        sampleWeight * sampledProbability + (1.0 - sampleWeight) * (1.0 - guess.missProbability);
+    const double score = hitProbability + pruningWeight * guess.expectedPruning;
+    if (score > bestScore || (score == bestScore && tiedBefore(guess, word, *bestGuess, bestWord))) {
+      bestGuess = &guess;
+      bestWord = word;
+      bestScore = score;
+      bestHitProbability = hitProbability;
+    }
+  }
+  if (bestGuess == nullptr) {
+    return std::nullopt;
+  }
+  RankedAnswer best = rankAnswer(*crossword_, bestGuess->slot, bestWord);
+  best.confidence = bestHitProbability;
+  return best;
+}
+
+std::optional<RankedAnswer> SolveSession::nextWord() {
+  WSR_PROFILE_SCOPE();
+  if (!crossword_.has_value()) {
+    for (const auto word : stored_) {
+      if (!isAccepted_(word)) {
+        return RankedAnswer{word, {}, 1, 0, 1.0};
+      }
+    }
+    return std::nullopt;
+  }
+  if (!crossword_->consistent()) {
+    return std::nullopt;
+  }
+  if (policy_ == GuessPolicy::POLICY_EXPECTED_COST) {
+    return expectedCostWord_();
+  }
+  if (!fill_.has_value()) {
+    fill_ = crossword_->solveAnytime({});
+  }
+
+  std::optional<RankedAnswer> best = {};
+  for (std::size_t s = 0; s < fill_->words.size(); ++s) {
+    const std::string_view word = fill_->words[s];
+    if (solved_[s] || word.empty() || isAccepted_(word)) {
+      continue;
+    }
+    const RankedAnswer answer = rankAnswer(*crossword_, s, word);
+    if (!best.has_value() || answer.confidence > best->confidence) {
+      best = answer;
+    }
+  }
+  return best;
+}
+
+void SolveSession::setGuessPolicy(GuessPolicy policy) noexcept {
+  policy_ = policy;
+}
+
+SolveSession Solver::startSession(const Matrix<char> &grid, std::string_view letters) const {
+  WSR_PROFILE_SCOPE();
+  std::optional<std::vector<std::string_view>> stored = querySolve_(grid, letters);
+  if (!stored.has_value()) {
+    return SolveSession(database_, grid, letters);
+  }
+  SolveSession session = {};
+  session.grid_ = grid;
+  session.stored_ = std::move(*stored);
+  return session;
+}
+
+void Solver::setLayoutTolerance(std::size_t cells) {
+  layoutTolerance_ = std::min(cells, maxLayoutTolerance);
+}
+
+void Solver::setDatabaseLookup(bool enabled) noexcept {
+  databaseLookup_ = enabled;
+}
+
+void Solver::setSearchThreads(std::size_t threadCount) {
+  if (threadCount == 1) {
+    searchPool_.reset();
+  } else {
+    searchPool_ = std::make_unique<utils::ThreadPool>(threadCount);
+  }
+}
+
+std::vector<std::string_view> Solver::solve(const Matrix<char> &grid, std::string_view letters) const {
   WSR_LOGMSG(logQueryGridSuccess) = "Query successful. Found matching entry...";
   WSR_LOGMSG(logQueryGridFail) = "Query unsuccessful. Using dictionary fallback...";
   WSR_PROFILE_SCOPE();
-  const auto queryResult = querySolve_(grid, letters);
-  if (!queryResult.empty()) {
+  std::optional<std::vector<std::string_view>> queryResult = querySolve_(grid, letters);
+  if (queryResult.has_value()) {
     utils::logMessage(utils::LogSeverity::LOG_INFO, logQueryGridSuccess);
-    return queryResult;
+    return std::move(*queryResult);
   }
   utils::logMessage(utils::LogSeverity::LOG_ERROR, logQueryGridFail);
   return fallbackDictionarySolve_(grid, letters);
 }
 
+PartialSolution Solver::solve(
+    const Matrix<char> &grid, std::string_view letters, std::chrono::steady_clock::time_point deadline
+) const {
+  WSR_LOGMSG(logQueryGridSuccess) = "Query successful. Found matching entry...";
+  WSR_LOGMSG(logQueryGridFail) = "Query unsuccessful. Searching until the deadline...";
+  WSR_PROFILE_SCOPE();
+  std::optional<std::vector<std::string_view>> queryResult = querySolve_(grid, letters);
+  if (queryResult.has_value()) {
+    utils::logMessage(utils::LogSeverity::LOG_INFO, logQueryGridSuccess);
+    PartialSolution solution = {{}, true};
+    for (const auto word : *queryResult) {
+      solution.answers.push_back({word, {}, 1, 0, 1.0});
+    }
+    return solution;
+  }
+  utils::logMessage(utils::LogSeverity::LOG_ERROR, logQueryGridFail);
+  PartialSolution solution = anytimeSolve_(grid, letters, deadline);
+  utils::logMessage(
+      utils::LogSeverity::LOG_INFO,
+      std::format(
+          "Search {} with {} answers.", solution.complete ? "completed" : "stopped", solution.answers.size()
+      )
+  );
+  return solution;
+}
+
 }  // namespace wsr
\ No newline at end of file
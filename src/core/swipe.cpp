@@ -0,0 +1,159 @@
+/**
+ * swipe.cpp
+ *
+ * Implementation for swipe.hpp
+ */
+
+#include "core/swipe.hpp"
+
+#include "core/pch.hpp"
+#include "utils/utilities.hpp"
+
+namespace {
+
+bool sameLetter(char a, char b) noexcept {
+  return (a & ~0x20) == (b & ~0x20);
+}
+
+float distance(cv::Point a, cv::Point b) noexcept {
+  return std::hypot(float(a.x - b.x), float(a.y - b.y));
+}
+
+}  // namespace
+
+namespace wsr::detail {
+
+std::optional<WheelPath> wheelPath(std::string_view word, std::string_view letters) {
+  WheelPath path = {};
+  path.reserve(word.size());
+  std::array<bool, UINT8_MAX + 1> used = {};
+  for (const char c : word) {
+    std::size_t position = 0;
+    while (position < letters.size() && (used[position] || !sameLetter(letters[position], c))) {
+      ++position;
+    }
+    if (position == letters.size() || position > UINT8_MAX) {
+      return std::nullopt;
+    }
+    used[position] = true;
+    path.push_back(std::uint8_t(position));
+  }
+  return path;
+}
+
+std::optional<WheelPath> shortestWheelPath(
+    std::string_view word, std::string_view letters, std::span<const cv::Point> positions
+) {
+  WSR_PROFILE_SCOPE();
+  const std::size_t n = letters.size();
+  if (n > maxPlannedWheelSize || positions.size() != n) {
+    return wheelPath(word, letters);
+  }
+  if (word.empty() || word.size() > n) {
+    return word.empty() ? std::optional(WheelPath{}) : std::nullopt;
+  }
+
+  // Shortest drag that spells the word's first letters, by the set of positions
+  // it used and the position it ended on, visiting sets in increasing order.
+  constexpr float unreachable = std::numeric_limits<float>::infinity();
+  const std::size_t stateCount = (std::size_t(1) << n) * n;
+  std::vector<float> length(stateCount, unreachable);
+  std::vector<std::uint8_t> previous(stateCount);
+  for (std::size_t p = 0; p < n; ++p) {
+    if (sameLetter(letters[p], word[0])) {
+      length[(std::size_t(1) << p) * n + p] = 0.0F;
+    }
+  }
+  float best = unreachable;
+  std::size_t bestState = stateCount;
+  for (std::size_t used = 1; used < (std::size_t(1) << n); ++used) {
+    const auto spelled = std::size_t(std::popcount(used));
+    if (spelled > word.size()) {
+      continue;
+    }
+    for (std::size_t last = 0; last < n; ++last) {
+      const std::size_t state = used * n + last;
+      if (length[state] == unreachable) {
+        continue;
+      }
+      if (spelled == word.size()) {
+        if (length[state] < best) {
+          best = length[state];
+          bestState = state;
+        }
+        continue;
+      }
+      for (std::size_t p = 0; p < n; ++p) {
+        if (((used >> p) & 1U) || !sameLetter(letters[p], word[spelled])) {
+          continue;
+        }
+        const std::size_t next = (used | (std::size_t(1) << p)) * n + p;
+        const float candidate = length[state] + distance(positions[last], positions[p]);
+        if (candidate < length[next]) {
+          length[next] = candidate;
+          previous[next] = std::uint8_t(last);
+        }
+      }
+    }
+  }
+  if (bestState == stateCount) {
+    return std::nullopt;
+  }
+
+  WheelPath path(word.size());
+  std::size_t used = bestState / n;
+  std::size_t last = bestState % n;
+  for (std::size_t i = word.size(); i-- > 0;) {
+    path[i] = std::uint8_t(last);
+    const std::size_t before = previous[used * n + last];
+    used &= ~(std::size_t(1) << last);
+    last = before;
+  }
+  return path;
+}
+
+}  // namespace wsr::detail
+
+namespace wsr {
+
+SwipePlan::SwipePlan(const Level &level, std::span<const std::string_view> answers) {
+  WSR_PROFILE_SCOPE();
+  WSR_ASSERT(level.letters.size() == level.letterLocations.size());
+  const std::string_view letters(level.letters.data(), level.letters.size());
+  std::vector<cv::Point> centers = {};
+  centers.reserve(level.letterLocations.size());
+  for (const auto &location : level.letterLocations) {
+    centers.emplace_back(
+        level.wheel.x + location.x + location.width / 2, level.wheel.y + location.y + location.height / 2
+    );
+  }
+
+  paths_.reserve(answers.size());
+  for (const auto word : answers) {
+    std::optional<detail::WheelPath> wheel = detail::shortestWheelPath(word, letters, centers);
+    if (!wheel.has_value()) {
+      utils::logMessage(
+          utils::LogSeverity::LOG_ERROR, std::format("Wheel cannot spell the answer {}.", word)
+      );
+      continue;
+    }
+    SwipePath &path = paths_.emplace_back(word, std::move(*wheel));
+    path.waypoints.reserve(path.wheel.size());
+    for (const auto position : path.wheel) {
+      path.waypoints.push_back(centers[position]);
+    }
+  }
+}
+
+std::span<const SwipePath> SwipePlan::paths() const noexcept {
+  return paths_;
+}
+
+const SwipePath *SwipePlan::find(std::string_view word) const noexcept {
+  const auto it = std::ranges::find_if(paths_, [word](const SwipePath &path) {
+    return std::ranges::equal(path.word, word, sameLetter);
+  });
+  return it == paths_.end() ? nullptr : &*it;
+}
+
+}  // namespace wsr
@@ -0,0 +1,175 @@
+#include "core/crossword.hpp"
+#include "core/pch.hpp"
+#include "core/reader.hpp"
+#include "core/solver.hpp"
+#include "utils/utilities.hpp"
+
+#include <opencv2/core/utils/allocator_stats.hpp>
+
+namespace {
+
+std::atomic<std::size_t> allocationCount = 0;
+
+// Counts the allocations made while running a function.
+template <typename F>
+std::size_t countAllocations(F &&function) {
+  const std::size_t before = allocationCount.load();
+  function();
+  return allocationCount.load() - before;
+}
+
+// Counts the cv::Mat buffers allocated inside OpenCV while running a function,
+// which the replaced operator new never sees.
+template <typename F>
+std::size_t countMatAllocations(F &&function) {
+  const auto &stats = cv::getAllocatorStatistics();
+  const auto before = stats.getNumberOfAllocations();
+  function();
+  return std::size_t(stats.getNumberOfAllocations() - before);
+}
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  ++allocationCount;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+int main() {
+  using wsr::detail::QueryType;
+  const wsr::detail::Database database = {};
+
+  constexpr int lx = 9;
+  constexpr int ly = 7;
+  std::string_view layout = "000111101111100101010101111011100001000001111000001000000001000";
+  std::string_view letters = "DSOLI";
+
+  wsr::Matrix<char> matrix(lx, ly);
+  for (int y = 0; y < ly; ++y) {
+    for (int x = 0; x < lx; ++x) {
+      const int i = y * lx + x;
+      matrix[{x, y}] = layout[i];
+    }
+  }
+
+  // The same grid with the letters of one answer revealed, which queries must place.
+  wsr::Matrix<char> revealed = matrix;
+  const std::optional<wsr::detail::LevelData> level = database.query(matrix, letters);
+  const wsr::detail::LayoutAnalysis analysis =
+      database.layoutAnalysis(*wsr::detail::LayoutKey::fromGrid(matrix));
+  if (level.has_value()) {
+    const auto placement = wsr::detail::Crossword(analysis, matrix, level->words).solve();
+    for (std::size_t i = 0; placement.has_value() && i < analysis.slots[0].length; ++i) {
+      revealed[analysis.slots[0].cell(i)] = (*placement)[0][i];
+    }
+  }
+
+  // Buffers are warmed up once, so later queries only reuse their capacity.
+  std::vector<std::uint32_t> ids = {};
+  database.queryIds(letters, QueryType::QUERY_SUBSETS, ids);
+  database.generateIds(letters, {}, ids);
+  std::ignore = database.queryView(revealed, letters);
+
+  std::size_t matchCount = 0;
+  std::optional<wsr::detail::LevelView> view = {};
+  std::optional<wsr::detail::LevelView> revealedView = {};
+  const std::array<std::pair<std::string_view, std::size_t>, 6> counts = {{
+      {"Database::query(grid)", countAllocations([&] { std::ignore = database.query(matrix, letters); })},
+      {"Database::queryView(grid)", countAllocations([&] { view = database.queryView(matrix, letters); })},
+      {"Database::queryView(revealed grid)", countAllocations([&] {
+         revealedView = database.queryView(revealed, letters);
+       })},
+      {"Database::matches()", countAllocations([&] {
+         for (const auto id : database.matches(letters, QueryType::QUERY_INEQUALITY)) {
+           matchCount += id != 0;
+         }
+       })},
+      {"Database::queryIds()", countAllocations([&] {
+         database.queryIds(letters, QueryType::QUERY_SUBSETS, ids);
+       })},
+      {"Database::generateIds()", countAllocations([&] { database.generateIds(letters, {}, ids); })},
+  }};
+
+  int failures = 0;
+  for (const auto &[name, count] : counts) {
+    std::cout << name << ": " << count << " allocations\n";
+  }
+  // Everything but the copying query must stay allocation free.
+  for (std::size_t i = 1; i < counts.size(); ++i) {
+    if (counts[i].second != 0) {
+      std::cout << "FAILED: " << counts[i].first << " allocates.\n";
+      ++failures;
+    }
+  }
+  if (revealed.data() == matrix.data()) {
+    std::cout << "FAILED: no letters were revealed.\n";
+    ++failures;
+  }
+  if (!view.has_value() || !revealedView.has_value() || matchCount == 0) {
+    std::cout << "FAILED: queries found nothing.\n";
+    ++failures;
+  }
+
+  // A word drawn from the templates, each letter scaled to a different size.
+  const wsr::Reader reader = {};
+  const std::string_view word = "WHEEL";
+  cv::Mat image = {64, 64 * int(word.size()), CV_8UC1, cv::Scalar(0)};
+  std::vector<cv::Rect> bboxes = {};
+  for (std::size_t i = 0; i < word.size(); ++i) {
+    const auto path = wsr::utils::getRoot() / "data" / "templates" / std::format("{}.png", word[i]);
+    const int side = 40 + 4 * int(i);
+    cv::Mat letter = cv::imread(path.string(), cv::IMREAD_GRAYSCALE);
+    cv::resize(letter, letter, cv::Size(side, side));
+    const cv::Rect &bbox = bboxes.emplace_back(64 * int(i), 0, side, side);
+    letter.copyTo(image(bbox));
+  }
+
+  // The first batch grows the glyph buffers, so only later batches are counted.
+  std::vector<std::pair<float, char>> glyphs = {};
+  const std::size_t warmupMatAllocations =
+      countMatAllocations([&] { reader.matchMany(image, bboxes, glyphs); });
+  const std::size_t matchAllocations =
+      countAllocations([&] { std::ignore = reader.match(image, bboxes.front()); });
+  std::size_t batchMatAllocations = 0;
+  const std::size_t batchAllocations = countAllocations([&] {
+    batchMatAllocations = countMatAllocations([&] { reader.matchMany(image, bboxes, glyphs); });
+  });
+  std::cout << "Reader::match(): " << matchAllocations << " allocations\n";
+  std::cout << "Reader::matchMany(): " << batchAllocations << " allocations, "
+            << batchMatAllocations << " cv::Mat allocations\n";
+  if (batchAllocations != 0 || batchMatAllocations != 0) {
+    std::cout << "FAILED: Reader::matchMany() allocates.\n";
+    ++failures;
+  }
+  // Growing the buffers must show up, or OpenCV is not counting its allocations.
+  if (warmupMatAllocations == 0) {
+    std::cout << "FAILED: OpenCV allocator statistics are disabled.\n";
+    ++failures;
+  }
+  std::string read = {};
+  for (const auto &[conf, ch] : glyphs) {
+    read.push_back(ch);
+  }
+  if (read != word) {
+    std::cout << "FAILED: Reader::matchMany() read " << read << ".\n";
+    ++failures;
+  }
+  // Every glyph was read before, so the later lookups all hit the cache.
+  const wsr::GlyphCacheStats stats = reader.glyphCacheStats();
+  if (stats.hits < bboxes.size() + 1 || stats.misses > bboxes.size()) {
+    std::cout << "FAILED: Reader glyph cache missed repeated glyphs.\n";
+    ++failures;
+  }
+  return failures;
+}
@@ -0,0 +1,107 @@
+#include "core/pch.hpp"
+#include "core/service.hpp"
+
+int main() {
+  int failures = 0;
+  const auto check = [&failures](bool condition, std::string_view name) {
+    if (!condition) {
+      std::cout << "FAILED: " << name << '\n';
+      ++failures;
+    }
+  };
+
+  // Repeated letters take distinct wheel positions.
+  check(wsr::detail::wheelPath("see", "ESXE") == wsr::detail::WheelPath{1, 0, 3}, "wheelPath(repeated)");
+  check(!wsr::detail::wheelPath("sees", "ESXE").has_value(), "wheelPath(unspellable)");
+
+  constexpr int lx = 9;
+  constexpr int ly = 7;
+  std::string_view layout = "000111101111100101010101111011100001000001111000001000000001000";
+  std::string_view letters = "DSOLI";
+
+  wsr::Matrix<char> matrix(lx, ly);
+  for (int y = 0; y < ly; ++y) {
+    for (int x = 0; x < lx; ++x) {
+      const int i = y * lx + x;
+      matrix[{x, y}] = layout[i];
+    }
+  }
+
+  std::vector<std::byte> message = {};
+  wsr::detail::encodeRequest(matrix, letters, message);
+  const auto request = wsr::detail::decodeRequest(std::span(message).subspan(wsr::detail::messageSizeBytes));
+  check(
+      request.has_value() && request->second == letters &&
+          std::ranges::equal(request->first.data(), matrix.data()),
+      "request round trip"
+  );
+  check(!wsr::detail::decodeRequest(std::span(message).subspan(3)).has_value(), "truncated request");
+
+  // Letters the solver does not accept are rejected before solving.
+  std::vector<std::byte> invalid = {};
+  wsr::detail::encodeRequest(matrix, "dsoli", invalid);
+  check(
+      !wsr::detail::decodeRequest(std::span(invalid).subspan(wsr::detail::messageSizeBytes)).has_value(),
+      "lowercase letters"
+  );
+
+  // Serves the level, then checks the paths spell the answers the solver gives.
+  const auto socketPath = std::filesystem::temp_directory_path() / "wordscraper_test.sock";
+  wsr::SolverService service(socketPath, 2);
+  std::thread server([&service] { service.run(); });
+  {
+    wsr::SolverClient client(socketPath);
+    const std::vector<wsr::detail::WheelPath> paths = client.solve(matrix, letters);
+    const wsr::Solver solver = {};
+    const std::vector<std::string_view> answers = solver.solve(matrix, letters);
+    check(paths.size() == answers.size() && !paths.empty(), "answer count");
+    for (std::size_t i = 0; i < std::min(paths.size(), answers.size()); ++i) {
+      std::string word = {};
+      for (const auto position : paths[i]) {
+        word.push_back(letters[position]);
+      }
+      check(std::ranges::equal(word, answers[i], [](char a, char b) {
+        return std::toupper(a) == std::toupper(b);
+      }), word);
+    }
+  }
+  {
+    // A rejected request gets a reply, and the connection still serves the next one.
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.string().data(), socketPath.string().size());
+    wsr::detail::Socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    check(
+        connect(socket.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != SOCKET_ERROR,
+        "connect"
+    );
+    // A layout too large to be stored falls back to every word the wheel spells,
+    // more than a response holds.
+    wsr::Matrix<char> large(UINT8_MAX, ly);
+    for (int y = 0; y < ly; ++y) {
+      for (int x = 0; x < int(UINT8_MAX); ++x) {
+        large[{x, y}] = y % 2 == 0 && x % 3 != 2 ? '1' : '0';
+      }
+    }
+    using Request = std::tuple<const wsr::Matrix<char> &, std::string_view, std::string_view>;
+    const std::array<Request, 4> requests = {{
+        {matrix, "DS?LI", "non-letter wheel"},
+        {matrix, "dsoli", "lowercase wheel"},
+        {large, "ATONESRI", "too many answers"},
+        {matrix, letters, "valid request"},
+    }};
+    std::vector<std::byte> payload = {};
+    for (const auto &[grid, wheel, name] : requests) {
+      std::vector<std::byte> request = {};
+      wsr::detail::encodeRequest(grid, wheel, request);
+      const bool answered = socket.send(request) && socket.receive(payload);
+      const auto response = answered ? wsr::detail::decodeResponse(payload) : std::nullopt;
+      const auto expected = wheel == letters ? wsr::detail::ServiceStatus::STATUS_OK
+                                             : wsr::detail::ServiceStatus::STATUS_BAD_REQUEST;
+      check(response.has_value() && response->status == expected, name);
+    }
+  }
+  service.stop();
+  server.join();
+  return failures;
+}
@@ -0,0 +1,44 @@
+#include "core/pch.hpp"
+#include "core/swipe.hpp"
+
+int main() {
+  int failures = 0;
+  const auto check = [&failures](bool condition, std::string_view name) {
+    if (!condition) {
+      std::cout << "FAILED: " << name << '\n';
+      ++failures;
+    }
+  };
+
+  // A wheel on one line with two E's, the first listed far from the A.
+  wsr::Level level = {};
+  level.wheel = cv::Rect(100, 200, 120, 20);
+  level.letters = {'E', 'A', 'E', 'T'};
+  level.letterLocations = {
+      cv::Rect(100, 0, 10, 10), cv::Rect(10, 0, 10, 10), cv::Rect(0, 0, 10, 10), cv::Rect(50, 0, 10, 10)
+  };
+
+  const std::array<std::string_view, 4> answers = {"ae", "EAT", "eta", "EEE"};
+  const wsr::SwipePlan plan(level, answers);
+
+  check(plan.paths().size() == 3, "unspellable answer left out");
+  const wsr::SwipePath *ae = plan.find("AE");
+  check(ae != nullptr && ae->wheel == wsr::detail::WheelPath{1, 2}, "nearest repeated letter");
+  check(
+      ae != nullptr && ae->waypoints.size() == 2 && ae->waypoints[0].x == 115 && ae->waypoints[0].y == 205 &&
+          ae->waypoints[1].x == 105,
+      "screen waypoints"
+  );
+  const wsr::SwipePath *eat = plan.find("eat");
+  check(eat != nullptr && eat->wheel == wsr::detail::WheelPath{2, 1, 3}, "shortest drag");
+
+  // Positions are never reused, so both E's are taken when the word needs them.
+  const auto twoEs = wsr::detail::shortestWheelPath(
+      "eae",
+      "EAET",
+      std::array{cv::Point(100, 0), cv::Point(10, 0), cv::Point(0, 0), cv::Point(50, 0)}
+  );
+  check(twoEs.has_value() && (*twoEs)[0] != (*twoEs)[2], "no reused position");
+  check(plan.find("TEA") == nullptr, "missing answer");
+  return failures;
+}